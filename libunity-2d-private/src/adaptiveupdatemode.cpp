@@ -0,0 +1,242 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "adaptiveupdatemode.h"
+
+// libunity-2d
+#include <debug_p.h>
+
+// Qt
+#include <QApplication>
+#include <QDesktopWidget>
+#include <QRegion>
+#include <QVector>
+
+// Weight of the older frames in the cost estimation
+static const qreal DECAY = 0.9;
+
+// Per rectangle cost in microseconds, used until frames with different
+// numbers of rectangles have been painted
+static const qreal DEFAULT_RECT_COST = 30;
+
+// Do not bother clipping when the bounding rectangle covers most of the view
+static const qreal FULL_COVERAGE = 0.9;
+
+// Switching away from minimal updates needs a clear and lasting gain
+static const qreal SWITCH_MARGIN = 0.85;
+static const int SWITCH_FRAMES = 5;
+
+// Frames painted with bounding rectangle or full updates before checking
+// again with minimal updates
+static const int PROBE_INTERVAL = 120;
+
+AdaptiveUpdateMode::AdaptiveUpdateMode(QGraphicsView* view)
+: QObject(view)
+, m_view(view)
+, m_enabled(false)
+, m_mode(view->viewportUpdateMode())
+, m_sumRectRect(0)
+, m_sumRectArea(0)
+, m_sumAreaArea(0)
+, m_sumRectTime(0)
+, m_sumAreaTime(0)
+, m_candidate(QGraphicsView::MinimalViewportUpdate)
+, m_candidateFrames(0)
+, m_framesSinceProbe(0)
+, m_modeGauge(NULL)
+{
+}
+
+bool AdaptiveUpdateMode::isEnabled() const
+{
+    return m_enabled;
+}
+
+void AdaptiveUpdateMode::setEnabled(bool enabled)
+{
+    m_enabled = enabled;
+    if (m_enabled) {
+        setMode(QGraphicsView::MinimalViewportUpdate);
+    }
+}
+
+QGraphicsView::ViewportUpdateMode AdaptiveUpdateMode::mode() const
+{
+    return m_mode;
+}
+
+const char* AdaptiveUpdateMode::modeName(QGraphicsView::ViewportUpdateMode mode)
+{
+    switch (mode) {
+    case QGraphicsView::FullViewportUpdate:
+        return "full";
+    case QGraphicsView::MinimalViewportUpdate:
+        return "minimal";
+    case QGraphicsView::SmartViewportUpdate:
+        return "smart";
+    case QGraphicsView::BoundingRectViewportUpdate:
+        return "bounding rect";
+    case QGraphicsView::NoViewportUpdate:
+        return "none";
+    }
+    return "unknown";
+}
+
+void AdaptiveUpdateMode::beginFrame()
+{
+    if (m_enabled) {
+        m_paintTimer.start();
+    }
+}
+
+void AdaptiveUpdateMode::endFrame(const QRegion& dirtyRegion)
+{
+    if (!m_enabled || !m_paintTimer.isValid()) {
+        return;
+    }
+    const qint64 time = m_paintTimer.nsecsElapsed() / 1000;
+    m_paintTimer.invalidate();
+
+    /* Someone else changed the mode for a while, see
+       moveRootChildItemToShell() in the shell */
+    if (m_view->viewportUpdateMode() != m_mode) {
+        return;
+    }
+
+    const QVector<QRect> rects = dirtyRegion.rects();
+    qint64 area = 0;
+    Q_FOREACH(const QRect& rect, rects) {
+        area += qint64(rect.width()) * rect.height();
+    }
+    addSample(rects.count(), area, time);
+
+    switch (m_mode) {
+    case QGraphicsView::MinimalViewportUpdate:
+        UQ_METRIC_COUNT("viewport.frames.minimal");
+        break;
+    case QGraphicsView::BoundingRectViewportUpdate:
+        UQ_METRIC_COUNT("viewport.frames.bounding_rect");
+        break;
+    case QGraphicsView::FullViewportUpdate:
+        UQ_METRIC_COUNT("viewport.frames.full");
+        break;
+    default:
+        break;
+    }
+
+    if (m_mode != QGraphicsView::MinimalViewportUpdate) {
+        if (++m_framesSinceProbe >= PROBE_INTERVAL) {
+            setMode(QGraphicsView::MinimalViewportUpdate);
+        }
+        return;
+    }
+
+    const QGraphicsView::ViewportUpdateMode best = bestMode(dirtyRegion);
+    if (best == QGraphicsView::MinimalViewportUpdate) {
+        m_candidateFrames = 0;
+        return;
+    }
+    if (best == m_candidate) {
+        ++m_candidateFrames;
+    } else {
+        m_candidate = best;
+        m_candidateFrames = 1;
+    }
+    if (m_candidateFrames >= SWITCH_FRAMES) {
+        setMode(best);
+    }
+}
+
+void AdaptiveUpdateMode::addSample(int rectCount, qint64 area, qint64 time)
+{
+    m_sumRectRect = m_sumRectRect * DECAY + qreal(rectCount) * rectCount;
+    m_sumRectArea = m_sumRectArea * DECAY + qreal(rectCount) * area;
+    m_sumAreaArea = m_sumAreaArea * DECAY + qreal(area) * area;
+    m_sumRectTime = m_sumRectTime * DECAY + qreal(rectCount) * time;
+    m_sumAreaTime = m_sumAreaTime * DECAY + qreal(area) * time;
+}
+
+void AdaptiveUpdateMode::estimateCosts(qreal* rectCost, qreal* pixelCost) const
+{
+    const qreal det = m_sumRectRect * m_sumAreaArea - m_sumRectArea * m_sumRectArea;
+    if (det > 1e-6 * m_sumRectRect * m_sumAreaArea) {
+        *rectCost = (m_sumRectTime * m_sumAreaArea - m_sumAreaTime * m_sumRectArea) / det;
+        *pixelCost = (m_sumAreaTime * m_sumRectRect - m_sumRectTime * m_sumRectArea) / det;
+        if (*rectCost >= 0 && *pixelCost >= 0) {
+            return;
+        }
+    }
+    /* Not enough variety in the painted frames to tell the two costs apart */
+    *rectCost = DEFAULT_RECT_COST;
+    *pixelCost = m_sumAreaArea > 0
+        ? qMax<qreal>(0, (m_sumAreaTime - DEFAULT_RECT_COST * m_sumRectArea) / m_sumAreaArea)
+        : 0;
+}
+
+QGraphicsView::ViewportUpdateMode AdaptiveUpdateMode::bestMode(const QRegion& dirtyRegion) const
+{
+    const qint64 viewArea = qint64(m_view->viewport()->width()) * m_view->viewport()->height();
+    if (viewArea <= 0 || dirtyRegion.isEmpty()) {
+        return QGraphicsView::MinimalViewportUpdate;
+    }
+
+    const QVector<QRect> rects = dirtyRegion.rects();
+    qint64 area = 0;
+    Q_FOREACH(const QRect& rect, rects) {
+        area += qint64(rect.width()) * rect.height();
+    }
+    const QRect bounds = dirtyRegion.boundingRect();
+    const qint64 boundingArea = qint64(bounds.width()) * bounds.height();
+
+    qreal rectCost, pixelCost;
+    estimateCosts(&rectCost, &pixelCost);
+    const qreal minimalCost = rectCost * rects.count() + pixelCost * area;
+    const qreal boundingCost = rectCost + pixelCost * boundingArea;
+    if (boundingCost >= minimalCost * SWITCH_MARGIN) {
+        return QGraphicsView::MinimalViewportUpdate;
+    }
+    return boundingArea >= FULL_COVERAGE * viewArea
+        ? QGraphicsView::FullViewportUpdate
+        : QGraphicsView::BoundingRectViewportUpdate;
+}
+
+void AdaptiveUpdateMode::setMode(QGraphicsView::ViewportUpdateMode mode)
+{
+    m_candidateFrames = 0;
+    m_framesSinceProbe = 0;
+    const bool changed = mode != m_mode;
+    m_mode = mode;
+    m_view->setViewportUpdateMode(mode);
+
+    /* There is one view per screen for the shell, plus the spread: report
+       the mode of each. Views do not move between screens. */
+    if (m_modeGauge == NULL) {
+        const QByteArray name = QByteArray("viewport.update_mode.")
+            + m_view->metaObject()->className() + '.'
+            + QByteArray::number(QApplication::desktop()->screenNumber(m_view));
+        m_modeGauge = Unity2dMetrics::instance()->gauge(name.constData());
+    }
+    m_modeGauge->set(mode);
+    if (changed) {
+        UQ_DEBUG << "Viewport update mode of" << m_view << "is now" << modeName(mode);
+        UQ_METRIC_COUNT("viewport.mode_switches");
+        Q_EMIT modeChanged(mode);
+    }
+}
+
+#include "adaptiveupdatemode.moc"
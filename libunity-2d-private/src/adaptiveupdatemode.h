@@ -0,0 +1,102 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef ADAPTIVEUPDATEMODE_H
+#define ADAPTIVEUPDATEMODE_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QGraphicsView>
+#include <QObject>
+
+// Local
+#include "unity2dmetrics.h"
+
+class QRegion;
+
+/**
+ * Picks the viewport update mode of a raster QGraphicsView from what its
+ * frames actually cost.
+ *
+ * Painting a region costs roughly a fixed amount per rectangle (clipping,
+ * walking the items) plus an amount per pixel. Both are estimated from the
+ * painted frames, then used to compare the last dirty region painted as is
+ * (MinimalViewportUpdate) with its bounding rectangle
+ * (BoundingRectViewportUpdate). FullViewportUpdate is used when the bounding
+ * rectangle covers nearly the whole view, clipping is then pure overhead.
+ *
+ * Only minimal updates tell what the dirty rectangles are, so the other modes
+ * go back to minimal updates from time to time to check whether they are
+ * still the best choice.
+ *
+ * The chosen mode of each view is reported with a
+ * viewport.update_mode.<view class>.<screen> gauge (a
+ * QGraphicsView::ViewportUpdateMode value), e.g.
+ * viewport.update_mode.ShellDeclarativeView.1; the viewport.frames.*
+ * counters add up the frames of all the views.
+ */
+class AdaptiveUpdateMode : public QObject
+{
+    Q_OBJECT
+public:
+    AdaptiveUpdateMode(QGraphicsView* view);
+
+    bool isEnabled() const;
+
+    /**
+     * When enabled the view starts with minimal updates. When disabled, the
+     * update mode is left alone.
+     */
+    void setEnabled(bool enabled);
+
+    QGraphicsView::ViewportUpdateMode mode() const;
+
+    static const char* modeName(QGraphicsView::ViewportUpdateMode mode);
+
+    void beginFrame();
+    void endFrame(const QRegion& dirtyRegion);
+
+Q_SIGNALS:
+    void modeChanged(QGraphicsView::ViewportUpdateMode mode);
+
+private:
+    void addSample(int rectCount, qint64 area, qint64 time);
+    void estimateCosts(qreal* rectCost, qreal* pixelCost) const;
+    QGraphicsView::ViewportUpdateMode bestMode(const QRegion& dirtyRegion) const;
+    void setMode(QGraphicsView::ViewportUpdateMode mode);
+
+    QGraphicsView* m_view;
+    bool m_enabled;
+    QGraphicsView::ViewportUpdateMode m_mode;
+    QElapsedTimer m_paintTimer;
+
+    // Exponentially decayed sums for the least squares fit of
+    // time = rectCost * rectCount + pixelCost * area
+    qreal m_sumRectRect;
+    qreal m_sumRectArea;
+    qreal m_sumAreaArea;
+    qreal m_sumRectTime;
+    qreal m_sumAreaTime;
+
+    QGraphicsView::ViewportUpdateMode m_candidate;
+    int m_candidateFrames;
+    int m_framesSinceProbe;
+
+    Unity2dMetrics::Gauge* m_modeGauge;
+};
+
+#endif /* ADAPTIVEUPDATEMODE_H */
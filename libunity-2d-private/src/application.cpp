@@ -33,6 +33,7 @@
 #include "launcherutility.h"
 #include "bamf-matcher.h"
 #include "bamf-indicator.h"
+#include "desktopentryindex.h"
 
 #include "dbusmenuimporter.h"
 #include "gobjectcallback.h"
@@ -41,6 +42,7 @@
 
 // libunity-2d
 #include <unity2dtr.h>
+#include <unity2dmetrics.h>
 #include <debug_p.h>
 
 // Qt
@@ -214,7 +216,7 @@ Application::name() const
         return QString::fromUtf8(sn_startup_sequence_get_name(m_snStartupSequence.data()));
     }
 
-    return QString();
+    return m_snapshotEntry.name;
 }
 
 QString
@@ -242,7 +244,7 @@ Application::icon() const
         return QString::fromUtf8(sn_startup_sequence_get_icon_name(m_snStartupSequence.data()));
     }
 
-    return QString();
+    return m_snapshotEntry.icon;
 }
 
 QString
@@ -266,7 +268,7 @@ Application::desktop_file() const
         return QString::fromUtf8(g_desktop_app_info_get_filename((GDesktopAppInfo*)m_appInfo.data()));
     }
 
-    return QString();
+    return m_snapshotEntry.desktopFile;
 }
 
 QString
@@ -280,7 +282,7 @@ Application::executable() const
         return QString::fromUtf8(sn_startup_sequence_get_binary_name(m_snStartupSequence.data()));
     }
 
-    return QString();
+    return m_snapshotEntry.executable;
 }
 
 void
@@ -298,16 +300,21 @@ void
 Application::setDesktopFile(const QString& desktop_file)
 {
     QString oldDesktopFile = this->desktop_file();
+    m_snapshotEntry = LauncherStateSnapshot::Entry();
 
-    QByteArray byte_array = desktop_file.toUtf8();
-    gchar *file = byte_array.data();
+    DesktopEntryIndex* index = DesktopEntryIndex::instance();
+    QString path = desktop_file;
+    if (!desktop_file.startsWith("/")) {
+        /* It might just be a desktop file name; the index maps the desktop ids
+           of all the installed entries to their path, including the ones in
+           deeply nested directories (e.g. Wine programs). */
+        path = index->path(desktop_file);
+    }
 
-    if(desktop_file.startsWith("/")) {
-        /* It looks like a full path to a desktop file */
-        m_appInfo.reset((GAppInfo*)g_desktop_app_info_new_from_filename(file));
+    if (!path.isEmpty()) {
+        m_appInfo.reset((GAppInfo*)index->appInfo(path));
     } else {
-        /* It might just be a desktop file name; let GIO look for the actual
-           desktop file for us */
+        /* Not indexed (yet): let GIO look for the actual desktop file for us */
         /* The docs for g_desktop_app_info_new() says it respects "-" to "/"
            substitution as per XDG Menu Spec, but it only seems to work for
            exactly 1 substitution where as Wine programs often require many.
@@ -319,6 +326,8 @@ Application::setDesktopFile(const QString& desktop_file)
            https://bugzilla.gnome.org/show_bug.cgi?id=654566
            https://bugs.launchpad.net/unity-2d/+bug/794471
         */
+        QByteArray byte_array = desktop_file.toUtf8();
+        gchar *file = byte_array.data();
         int slash_index;
         do {
             m_appInfo.reset((GAppInfo*)g_desktop_app_info_new(file));
@@ -350,11 +359,21 @@ Application::setDesktopFile(const QString& desktop_file)
 
     /* Update the list of static shortcuts
        (quicklist entries defined in the desktop file). */
-    m_staticShortcuts.reset(indicator_desktop_shortcuts_new(newDesktopFile.toUtf8().constData(), "Unity"));
+    m_staticShortcuts.reset(index->staticShortcuts(newDesktopFile));
 
     monitorDesktopFile(newDesktopFile);
 }
 
+void
+Application::setSnapshotEntry(const LauncherStateSnapshot::Entry& entry)
+{
+    m_snapshotEntry = entry;
+    Q_EMIT desktopFileChanged(desktop_file());
+    Q_EMIT nameChanged(name());
+    Q_EMIT iconChanged(icon());
+    Q_EMIT executableChanged(executable());
+}
+
 void
 Application::monitorDesktopFile(const QString& path)
 {
@@ -879,12 +898,15 @@ Application::spread(bool showAllWorkspaces)
             fragments.append("xid=" + QString::number(xid));
         }
 
+        UQ_METRIC_COUNT("dbus.calls");
         compiz.asyncCall("activate", "root", static_cast<int>(root), "match", fragments.join(" | "));
     } else {
         QDBusInterface spread("com.canonical.Unity2d.Spread", "/Spread",
                               "com.canonical.Unity2d.Spread");
+        UQ_METRIC_COUNT("dbus.blocking_calls");
         QDBusReply<bool> isShown = spread.call("IsShown");
         if (isShown.isValid()) {
+            UQ_METRIC_COUNT("dbus.calls");
             if (isShown.value() == true) {
                 spread.asyncCall("FilterByApplication", m_application->desktop_file());
             } else {
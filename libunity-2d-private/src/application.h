@@ -24,6 +24,7 @@
 #include <libindicator/indicator-desktop-shortcuts.h>
 
 #include "launcheritem.h"
+#include "launcherstatesnapshot.h"
 
 // libunity-2d
 #include <gconnector.h>
@@ -98,6 +99,9 @@ public:
     void setBamfApplication(BamfApplication *application);
     void setSnStartupSequence(SnStartupSequence* sequence);
     void setIcon(const QString& iconPath);
+    /* Shows the application as it was saved in a LauncherStateSnapshot until
+       setDesktopFile() is called */
+    void setSnapshotEntry(const LauncherStateSnapshot::Entry& entry);
 
     /* methods */
     Q_INVOKABLE virtual void activate();
@@ -198,6 +202,7 @@ private:
     QTimer m_geometryChangedTimer;
     GConnector m_gConnector;
     QString m_overrideIconPath;
+    LauncherStateSnapshot::Entry m_snapshotEntry;
 };
 
 Q_DECLARE_METATYPE(Application*)
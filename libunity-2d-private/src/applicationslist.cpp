@@ -17,6 +17,7 @@
 #include "application.h"
 #include "applicationslist.h"
 #include "applicationslistmanager.h"
+#include "unity2ddeclarativeview.h"
 #include "webfavorite.h"
 
 #include "bamf-matcher.h"
@@ -26,6 +27,7 @@
 // unity-2d
 #include "config.h"
 #include <debug_p.h>
+#include <unity2dtrace.h>
 
 #include <QStringList>
 #include <QDir>
@@ -42,9 +44,16 @@ extern "C" {
 /* List of executables that are too generic to be matched against a single application. */
 static const QStringList EXECUTABLES_BLACKLIST = (QStringList() << "xdg-open");
 static const QByteArray LATEST_SETTINGS_MIGRATION = "3.2.10";
+/* Favorites tend to change in bursts (e.g. when reordering them), do not
+   rewrite the snapshot for each change */
+static const int SNAPSHOT_SAVE_DELAY = 1000;
+/* Loading is finished after the first frame, or after this delay if no
+   declarative view gets painted, e.g. when running in qmlviewer */
+static const int FINISH_LOADING_TIMEOUT = 2000;
 
 ApplicationsList::ApplicationsList(QObject *parent) :
     QAbstractListModel(parent)
+    , m_loadingFinished(false)
 {
     /* Register the display to receive startup notifications */
     Display *xdisplay = QX11Info::display();
@@ -71,6 +80,10 @@ ApplicationsList::ApplicationsList(QObject *parent) :
       m_xdgApplicationDirs << QDir::cleanPath(dirName + "/applications") + "/";
     }
 
+    m_snapshotSaveTimer.setSingleShot(true);
+    m_snapshotSaveTimer.setInterval(SNAPSHOT_SAVE_DELAY);
+    QObject::connect(&m_snapshotSaveTimer, SIGNAL(timeout()), SLOT(saveSnapshot()));
+
     load();
 
     ApplicationsListManager::instance()->addList(this);
@@ -310,6 +323,22 @@ ApplicationsList::insertFavoriteApplication(const QString& desktop_file)
     }
 }
 
+void
+ApplicationsList::insertSnapshotApplication(const LauncherStateSnapshot::Entry& entry)
+{
+    if (m_applicationForDesktopFile.contains(entry.desktopFile)) {
+        return;
+    }
+
+    Application* application = new Application;
+    application->setSnapshotEntry(entry);
+    /* Set before inserting so that the unchanged favorites are not written
+       back to GConf */
+    application->setSticky(true);
+    insertApplication(application);
+    m_snapshotApplications.append(application);
+}
+
 void
 ApplicationsList::insertWebFavorite(const QUrl& url)
 {
@@ -352,6 +381,7 @@ ApplicationsList::insertSnStartupSequence(SnStartupSequence* sequence)
 void
 ApplicationsList::load()
 {
+    UQ_TRACE_SCOPE("ApplicationsList::load");
     /* Migrate the favorites if needed and ignore errors */
     QByteArray latest_migration = launcherConfiguration().property("favoriteMigration").toString().toAscii();
     if (latest_migration < LATEST_SETTINGS_MIGRATION) {
@@ -360,16 +390,70 @@ ApplicationsList::load()
         }
     }
 
-    /* Insert favorites */
-    QString desktop_file;
+    /* Insert favorites. If they did not change since the last session, show
+       them as they were right away: their desktop files are loaded and bamf
+       is queried once the launcher has been painted. */
     QStringList favorites = launcherConfiguration().property("favorites").toStringList();
+    LauncherStateSnapshot snapshot;
+    if (snapshot.load() && snapshot.favorites() == favorites) {
+        Q_FOREACH(const LauncherStateSnapshot::Entry& entry, snapshot.entries()) {
+            insertSnapshotApplication(entry);
+        }
+    } else {
+        Q_FOREACH(const QString& favorite, favorites) {
+           insertFavoriteApplication(favorite);
+        }
+    }
+
+    /* load() runs while the QML is being created, before the view is shown:
+       a zero delay timer would fire before the first frame */
+    Unity2DDeclarativeView::invokeAfterFirstFrame(this, "finishLoading");
+    QTimer::singleShot(FINISH_LOADING_TIMEOUT, this, SLOT(finishLoading()));
+}
 
-    Q_FOREACH(const QString& favorite, favorites) {
-       insertFavoriteApplication(favorite);
+void
+ApplicationsList::finishLoading()
+{
+    if (m_loadingFinished) {
+        return;
+    }
+    m_loadingFinished = true;
+    UQ_TRACE_SCOPE("ApplicationsList::finishLoading");
+    BamfMatcher& matcher = BamfMatcher::get_default();
+
+    /* Replace the snapshot data with the actual desktop files */
+    QStringList snapshotDesktopFiles;
+    bool favoritesRemoved = false;
+    Q_FOREACH(const QPointer<Application>& application, m_snapshotApplications) {
+        if (application.isNull()) {
+            continue;
+        }
+        const QString desktop_file = application->desktop_file();
+        const QString executable = application->executable();
+        application->setDesktopFile(desktop_file);
+        if (application->desktop_file().isEmpty()) {
+            UQ_WARNING << "Favorite application removed due to desktop file missing or corrupted ("
+                       << desktop_file << ")";
+            /* The keys it was registered with are gone with the snapshot data */
+            m_applicationForDesktopFile.remove(desktop_file);
+            m_applicationForExecutable.remove(executable);
+            removeApplication(application.data());
+            favoritesRemoved = true;
+        } else {
+            snapshotDesktopFiles.append(desktop_file);
+        }
+    }
+    m_snapshotApplications.clear();
+    if (!snapshotDesktopFiles.isEmpty()) {
+        /* See insertFavoriteApplication() */
+        matcher.register_favorites(snapshotDesktopFiles);
+    }
+    if (favoritesRemoved) {
+        writeFavoritesToGConf();
     }
 
     /* Insert running applications from Bamf */
-    BamfMatcher& matcher = BamfMatcher::get_default();
+    UQ_TRACE_SCOPE("bamf running applications");
     QScopedPointer<BamfApplicationList> running_applications(matcher.running_applications());
     BamfApplication* bamf_application;
 
@@ -379,6 +463,9 @@ ApplicationsList::load()
     }
 
     QObject::connect(&matcher, SIGNAL(ViewOpened(BamfView*)), SLOT(onBamfViewOpened(BamfView*)));
+
+    /* Names and icons may have changed since the snapshot was taken */
+    scheduleSnapshotSave();
 }
 
 void
@@ -455,6 +542,35 @@ ApplicationsList::writeFavoritesToGConf()
     launcherConfiguration().blockSignals(true);
     launcherConfiguration().setProperty("favorites", QVariant(favorites));
     launcherConfiguration().blockSignals(false);
+
+    scheduleSnapshotSave();
+}
+
+void
+ApplicationsList::scheduleSnapshotSave()
+{
+    m_snapshotSaveTimer.start();
+}
+
+void
+ApplicationsList::saveSnapshot()
+{
+    QList<LauncherStateSnapshot::Entry> entries;
+    Q_FOREACH(Application *application, m_applications) {
+        if (application->sticky() && !application->desktop_file().isEmpty()) {
+            LauncherStateSnapshot::Entry entry;
+            entry.desktopFile = application->desktop_file();
+            entry.name = application->name();
+            entry.icon = application->icon();
+            entry.executable = application->executable();
+            entries.append(entry);
+        }
+    }
+
+    LauncherStateSnapshot snapshot;
+    snapshot.setFavorites(launcherConfiguration().property("favorites").toStringList());
+    snapshot.setEntries(entries);
+    snapshot.save();
 }
 
 int
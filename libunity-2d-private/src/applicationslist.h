@@ -27,9 +27,13 @@
 #include <QtDeclarative/qdeclarative.h>
 #include <QMap>
 #include <QDBusContext>
+#include <QPointer>
+#include <QTimer>
 
 #include <unity2dapplication.h>
 
+#include "launcherstatesnapshot.h"
+
 struct SnDisplay;
 struct SnMonitorContext;
 struct SnMonitorEvent;
@@ -66,6 +70,7 @@ private:
     void insertBamfApplication(BamfApplication* bamf_application);
     void insertSnStartupSequence(SnStartupSequence* sequence);
     void insertFavoriteApplication(const QString& desktop_file);
+    void insertSnapshotApplication(const LauncherStateSnapshot::Entry& entry);
     void insertWebFavorite(const QUrl& url);
 
     void insertApplication(Application* application);
@@ -75,6 +80,7 @@ private:
     QString favoriteFromDesktopFilePath(const QString& desktop_file) const;
 
     void writeFavoritesToGConf();
+    void scheduleSnapshotSave();
 
     void remoteEntryUpdated(const QString& desktopFile, const QString& sender, const QString& applicationURI, const QMap<QString, QVariant>& properties);
 
@@ -96,6 +102,12 @@ private:
     QHash<QString, Application*> m_applicationForExecutable;
     QStringList m_xdgApplicationDirs;
 
+    /* Favorites shown from the launcher state snapshot, waiting for their
+       desktop file to be loaded */
+    QList<QPointer<Application> > m_snapshotApplications;
+    QTimer m_snapshotSaveTimer;
+    bool m_loadingFinished;
+
     /* Startup notification support */
     SnDisplay *m_snDisplay;
     SnMonitorContext *m_snContext;
@@ -103,6 +115,8 @@ private:
     void onSnMonitorEventReceived(SnMonitorEvent *event);
 
 private Q_SLOTS:
+    void finishLoading();
+    void saveSnapshot();
     void onApplicationClosed();
     void onBamfViewOpened(BamfView* bamf_view);
     void onApplicationStickyChanged(bool sticky);
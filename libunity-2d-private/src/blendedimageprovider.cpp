@@ -17,6 +17,7 @@
 #include "blendedimageprovider.h"
 #include <QPainter>
 #include <debug_p.h>
+#include <unity2dmetrics.h>
 
 BlendedImageProvider::BlendedImageProvider(QUrl baseUrl) : QDeclarativeImageProvider(QDeclarativeImageProvider::Image),
                                                            m_baseUrl(baseUrl)
@@ -29,6 +30,7 @@ BlendedImageProvider::~BlendedImageProvider()
 
 QImage BlendedImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
 {
+    UQ_METRIC_LATENCY("imageprovider.blended.latency");
     /* id is of the form [FILENAME]color=[COLORNAME]alpha=[FLOAT] */
     QRegExp rx("^(.+)color=(.+)alpha=(\\d+(?:\\.\\d+)?)$");
     if (rx.indexIn(id)) {
@@ -20,26 +20,36 @@ DecayedValue::DecayedValue()
  : m_value(0)
  , m_target(0)
  , m_decayRate(0)
+ , m_timestamp(0)
 {
-    m_valueDecayTimer.setInterval(10);
-    connect(&m_valueDecayTimer, SIGNAL(timeout()), this, SLOT(decay()));
 }
 
-bool DecayedValue::addAndCheckExceedingTarget(int i)
+bool DecayedValue::addAndCheckExceedingTarget(qreal i, quint32 timestamp)
 {
-    m_value += i;
-    if (!m_valueDecayTimer.isActive()) {
-        m_valueDecayTimer.start();
-    }
+    m_value = value(timestamp) + i;
+    m_timestamp = timestamp;
     if (m_value > m_target) {
         m_value = 0;
-        m_valueDecayTimer.stop();
         return true;
     } else {
         return false;
     }
 }
 
+qreal DecayedValue::value(quint32 timestamp) const
+{
+    if (m_value <= 0) {
+        return 0;
+    }
+
+    // m_decayRate is the decay per second. Unsigned arithmetic takes care
+    // of the X server time wrapping around.
+    const quint32 elapsed = timestamp - m_timestamp;
+    const qreal decay = qreal(m_decayRate) * elapsed / 1000;
+
+    return qMax<qreal>(0, m_value - decay);
+}
+
 void DecayedValue::setDecayRate(int decayRate)
 {
     m_decayRate = decayRate;
@@ -49,17 +59,3 @@ void DecayedValue::setTarget(int target)
 {
     m_target = target;
 }
-
-void DecayedValue::decay() {
-  const int partial_decay = m_decayRate / 100;
-
-  m_value -= partial_decay;
-
-  if (m_value <= 0)
-  {
-    m_value = 0;
-    m_valueDecayTimer.stop();
-  }
-}
-
-#include "decayedvalue.moc"
\ No newline at end of file
@@ -17,29 +17,40 @@
 #ifndef DECAYEDVALUE_H
 #define DECAYEDVALUE_H
 
-#include <QObject>
+#include <QtGlobal>
 
-#include <QTimer>
-
-class DecayedValue : public QObject
+/**
+ * An accumulator whose value decreases linearly over time.
+ *
+ * The decay is computed from the timestamps passed to
+ * addAndCheckExceedingTarget() instead of being applied periodically, so an
+ * idle value costs nothing.
+ */
+class DecayedValue
 {
-    Q_OBJECT
 public:
     DecayedValue();
 
-    bool addAndCheckExceedingTarget(int i);
+    /**
+     * Adds @p i to the value at time @p timestamp (in milliseconds, as
+     * provided by the X server) after applying the decay since the previous
+     * call. Returns true and resets the value if it exceeds the target.
+     */
+    bool addAndCheckExceedingTarget(qreal i, quint32 timestamp);
+
+    /**
+     * Returns the value as it would be at time @p timestamp
+     */
+    qreal value(quint32 timestamp) const;
 
     void setDecayRate(int decayRate);
     void setTarget(int target);
 
-private Q_SLOTS:
-    void decay();
-
 private:
-    int m_value;
+    qreal m_value;
     int m_target;
     int m_decayRate;
-    QTimer m_valueDecayTimer;
+    quint32 m_timestamp;
 };
 
 #endif // DECAYEDVALUE_H
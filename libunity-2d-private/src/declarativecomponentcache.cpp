@@ -0,0 +1,109 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "declarativecomponentcache.h"
+
+// Local
+#include "unity2ddeclarativeview.h"
+
+// libunity-2d
+#include <debug_p.h>
+#include <unity2dmetrics.h>
+#include <unity2dtrace.h>
+
+// Qt
+#include <QDeclarativeComponent>
+#include <QDeclarativeEngine>
+#include <QElapsedTimer>
+
+// Let the first frames get painted and the startup D-Bus traffic settle down
+// before spending time on components nobody asked for yet
+static const int PRELOAD_DELAY = 2000;
+
+DeclarativeComponentCache::DeclarativeComponentCache()
+{
+    m_preloadTimer.setSingleShot(true);
+    connect(&m_preloadTimer, SIGNAL(timeout()), SLOT(preloadNext()));
+}
+
+DeclarativeComponentCache* DeclarativeComponentCache::instance()
+{
+    static DeclarativeComponentCache cache;
+    return &cache;
+}
+
+QUrl DeclarativeComponentCache::resolvedUrl(const QUrl& url) const
+{
+    return Unity2DDeclarativeView::engine()->baseUrl().resolved(url);
+}
+
+QDeclarativeComponent* DeclarativeComponentCache::component(const QUrl& url)
+{
+    const QUrl resolved = resolvedUrl(url);
+    const QString key = resolved.toString();
+    QDeclarativeComponent* component = m_components.value(key);
+    if (component != NULL) {
+        return component;
+    }
+
+    UQ_TRACE_SCOPE("QML compile");
+    QElapsedTimer timer;
+    timer.start();
+    component = new QDeclarativeComponent(Unity2DDeclarativeView::engine(), resolved, this);
+    const qint64 elapsed = timer.elapsed();
+    if (component->isError()) {
+        UQ_WARNING << component->errors();
+    }
+    m_components.insert(key, component);
+    m_compileTimes.insert(key, elapsed);
+    UQ_METRIC_GAUGE("componentcache.components", m_components.count());
+    UQ_DEBUG << "Compiled" << key << "in" << elapsed << "ms";
+    return component;
+}
+
+void DeclarativeComponentCache::preload(const QList<QUrl>& urls)
+{
+    m_preloadQueue += urls;
+    if (!m_preloadQueue.isEmpty() && !m_preloadTimer.isActive()) {
+        m_preloadTimer.start(PRELOAD_DELAY);
+    }
+}
+
+qint64 DeclarativeComponentCache::compileTime(const QUrl& url) const
+{
+    return m_compileTimes.value(resolvedUrl(url).toString(), -1);
+}
+
+int DeclarativeComponentCache::componentCount() const
+{
+    return m_components.count();
+}
+
+void DeclarativeComponentCache::preloadNext()
+{
+    if (m_preloadQueue.isEmpty()) {
+        return;
+    }
+    /* One component at a time, so that user input is not delayed much */
+    component(m_preloadQueue.takeFirst());
+    if (!m_preloadQueue.isEmpty()) {
+        m_preloadTimer.start(0);
+    }
+}
+
+#include "declarativecomponentcache.moc"
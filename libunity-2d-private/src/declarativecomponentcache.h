@@ -0,0 +1,81 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DECLARATIVECOMPONENTCACHE_H
+#define DECLARATIVECOMPONENTCACHE_H
+
+// Qt
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QTimer>
+#include <QUrl>
+
+class QDeclarativeComponent;
+
+/**
+ * Keeps the QML components of the process compiled, so that all the
+ * Unity2DDeclarativeView instances loading the same source share one
+ * QDeclarativeComponent.
+ *
+ * Components can also be compiled ahead of time with preload(): they are
+ * compiled one per event loop iteration once the process has been idle for a
+ * while, so that e.g. opening the dash for the first time does not have to
+ * compile its renderers.
+ */
+class DeclarativeComponentCache : public QObject
+{
+    Q_OBJECT
+public:
+    static DeclarativeComponentCache* instance();
+
+    /**
+     * Returns the component for @p url, compiling it the first time. Relative
+     * urls are resolved against the base url of the engine. The component is
+     * owned by the cache.
+     */
+    QDeclarativeComponent* component(const QUrl& url);
+
+    /**
+     * Queues @p urls to be compiled when idle
+     */
+    void preload(const QList<QUrl>& urls);
+
+    /**
+     * Time spent compiling @p url in milliseconds, or -1 if it has not been
+     * compiled yet
+     */
+    qint64 compileTime(const QUrl& url) const;
+
+    int componentCount() const;
+
+private Q_SLOTS:
+    void preloadNext();
+
+private:
+    DeclarativeComponentCache();
+    Q_DISABLE_COPY(DeclarativeComponentCache)
+
+    QUrl resolvedUrl(const QUrl& url) const;
+
+    QHash<QString, QDeclarativeComponent*> m_components;
+    QHash<QString, qint64> m_compileTimes;
+    QList<QUrl> m_preloadQueue;
+    QTimer m_preloadTimer;
+};
+
+#endif /* DECLARATIVECOMPONENTCACHE_H */
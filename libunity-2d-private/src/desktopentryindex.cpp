@@ -0,0 +1,352 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "desktopentryindex.h"
+
+// libunity-2d
+#include <debug_p.h>
+#include <gscopedpointer.h>
+
+// Qt
+#include <QDir>
+#include <QDirIterator>
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QPair>
+#include <QTimer>
+#include <QtConcurrentMap>
+
+// GIO
+#include <gio/gdesktopappinfo.h>
+#include <libindicator/indicator-desktop-shortcuts.h>
+
+// libc
+#include <stdlib.h>
+#include <sys/stat.h>
+
+// Package installations touch the applications directories many times in a
+// row, wait for things to settle down before rescanning
+static const int RESCAN_DELAY = 500;
+
+typedef QPair<QString, QString> IdAndPath;
+
+struct ScanResult
+{
+    QStringList dirs;
+    QList<IdAndPath> entries;
+};
+
+/* Runs in a worker thread: lists the desktop files found in @p root and its
+   subdirectories. The desktop id of a file is its path relative to @p root
+   with '/' replaced by '-', as per the XDG menu specification. */
+static ScanResult scanApplicationDir(const QString& root)
+{
+    ScanResult result;
+    const QString dir = QDir::cleanPath(root);
+    if (!QFileInfo(dir).isDir()) {
+        return result;
+    }
+    result.dirs << dir;
+
+    QDirIterator it(dir, QDir::Files | QDir::Dirs | QDir::NoDotAndDotDot,
+                    QDirIterator::Subdirectories | QDirIterator::FollowSymlinks);
+    while (it.hasNext()) {
+        const QString path = it.next();
+        const QFileInfo info = it.fileInfo();
+        if (info.isDir()) {
+            result.dirs << path;
+        } else if (path.endsWith(".desktop")) {
+            QString desktopId = path.mid(dir.length() + 1);
+            desktopId.replace('/', '-');
+            result.entries << IdAndPath(desktopId, path);
+        }
+    }
+    return result;
+}
+
+struct FileStamp
+{
+    time_t mtime;
+    long mtimeNsec;
+    off_t size;
+    ino_t inode;
+
+    static bool read(const QString& path, FileStamp* stamp)
+    {
+        struct stat buf;
+        if (stat(QFile::encodeName(path).constData(), &buf) != 0) {
+            return false;
+        }
+        stamp->mtime = buf.st_mtim.tv_sec;
+        stamp->mtimeNsec = buf.st_mtim.tv_nsec;
+        stamp->size = buf.st_size;
+        stamp->inode = buf.st_ino;
+        return true;
+    }
+
+    bool operator==(const FileStamp& other) const
+    {
+        return mtime == other.mtime && mtimeNsec == other.mtimeNsec
+            && size == other.size && inode == other.inode;
+    }
+};
+
+struct ParsedEntry
+{
+    FileStamp stamp;
+    GObjectScopedPointer<GDesktopAppInfo> appInfo;
+    GObjectScopedPointer<IndicatorDesktopShortcuts> shortcuts;
+    bool shortcutsLoaded;
+};
+
+class DesktopEntryIndexPrivate
+{
+public:
+    QStringList m_applicationDirs;
+    QHash<QString, QString> m_pathForId;
+    QHash<QString, QString> m_idForPath;
+    QHash<QString, ParsedEntry*> m_parsedEntries;
+    QFileSystemWatcher m_watcher;
+    QTimer m_rescanTimer;
+    QFutureWatcher<ScanResult> m_scanWatcher;
+    bool m_rescanPending;
+    int m_scanCount;
+    int m_parseCount;
+
+    void initApplicationDirs()
+    {
+        /* The user directory takes precedence over the system ones, as it
+           does for GIO */
+        QString dataHome = QFile::decodeName(getenv("XDG_DATA_HOME"));
+        if (dataHome.isEmpty()) {
+            dataHome = QDir::homePath() + "/.local/share";
+        }
+        QString dataDirs = QFile::decodeName(getenv("XDG_DATA_DIRS"));
+        if (dataDirs.isEmpty()) {
+            dataDirs = "/usr/local/share/:/usr/share/";
+        }
+        const QStringList dirNames = QStringList() << dataHome << dataDirs.split(':', QString::SkipEmptyParts);
+        Q_FOREACH(const QString& dirName, dirNames) {
+            const QString applicationDir = QDir::cleanPath(dirName + "/applications") + "/";
+            if (!m_applicationDirs.contains(applicationDir)) {
+                m_applicationDirs << applicationDir;
+            }
+        }
+    }
+
+    /* Scans the applications directories in worker threads, the results are
+       applied by applyScan() once they are all in */
+    void startScan()
+    {
+        if (m_scanWatcher.isRunning()) {
+            m_rescanPending = true;
+            return;
+        }
+        m_rescanPending = false;
+        ++m_scanCount;
+        m_scanWatcher.setFuture(QtConcurrent::mapped(m_applicationDirs, scanApplicationDir));
+    }
+
+    /* Returns true if entries have been added or removed */
+    bool applyScan()
+    {
+        const QList<ScanResult> results = m_scanWatcher.future().results();
+
+        QHash<QString, QString> pathForId;
+        QStringList watchedDirs;
+        for (int i = 0; i < results.count(); ++i) {
+            const ScanResult& result = results.at(i);
+            if (result.dirs.isEmpty()) {
+                /* Watch the parent so that we notice when the applications
+                   directory gets created */
+                const QString parent = QDir::cleanPath(m_applicationDirs.at(i) + "..");
+                if (QFileInfo(parent).isDir()) {
+                    watchedDirs << parent;
+                }
+                continue;
+            }
+            watchedDirs << result.dirs;
+            Q_FOREACH(const IdAndPath& entry, result.entries) {
+                if (!pathForId.contains(entry.first)) {
+                    pathForId.insert(entry.first, entry.second);
+                }
+            }
+        }
+
+        if (!m_watcher.directories().isEmpty()) {
+            m_watcher.removePaths(m_watcher.directories());
+        }
+        if (!watchedDirs.isEmpty()) {
+            m_watcher.addPaths(watchedDirs);
+        }
+
+        if (pathForId == m_pathForId) {
+            return false;
+        }
+        m_pathForId = pathForId;
+        m_idForPath.clear();
+        QHash<QString, QString>::const_iterator it = m_pathForId.constBegin(), end = m_pathForId.constEnd();
+        for (; it != end; ++it) {
+            m_idForPath.insert(it.value(), it.key());
+        }
+
+        /* Forget about the parsed entries which went away */
+        QHash<QString, ParsedEntry*>::iterator parsedIt = m_parsedEntries.begin();
+        while (parsedIt != m_parsedEntries.end()) {
+            if (m_idForPath.contains(parsedIt.key())) {
+                ++parsedIt;
+            } else {
+                delete parsedIt.value();
+                parsedIt = m_parsedEntries.erase(parsedIt);
+            }
+        }
+        return true;
+    }
+
+    /* Returns the parsed entry for @p path, reparsing it if the file changed
+       since last time */
+    ParsedEntry* parsedEntry(const QString& path)
+    {
+        FileStamp stamp;
+        if (!FileStamp::read(path, &stamp)) {
+            delete m_parsedEntries.take(path);
+            return NULL;
+        }
+        ParsedEntry* entry = m_parsedEntries.value(path);
+        if (entry != NULL && entry->stamp == stamp) {
+            return entry;
+        }
+        if (entry == NULL) {
+            entry = new ParsedEntry;
+            m_parsedEntries.insert(path, entry);
+        }
+        ++m_parseCount;
+        entry->stamp = stamp;
+        entry->appInfo.reset(g_desktop_app_info_new_from_filename(QFile::encodeName(path).constData()));
+        entry->shortcuts.reset();
+        entry->shortcutsLoaded = false;
+        return entry;
+    }
+};
+
+DesktopEntryIndex::DesktopEntryIndex()
+: d(new DesktopEntryIndexPrivate)
+{
+    d->m_scanCount = 0;
+    d->m_parseCount = 0;
+    d->m_rescanPending = false;
+    d->m_rescanTimer.setSingleShot(true);
+    d->m_rescanTimer.setInterval(RESCAN_DELAY);
+    connect(&d->m_rescanTimer, SIGNAL(timeout()), SLOT(rescan()));
+    connect(&d->m_watcher, SIGNAL(directoryChanged(QString)), SLOT(onDirectoryChanged()));
+    connect(&d->m_scanWatcher, SIGNAL(finished()), SLOT(onScanFinished()));
+
+    d->initApplicationDirs();
+    d->startScan();
+}
+
+DesktopEntryIndex::~DesktopEntryIndex()
+{
+    d->m_scanWatcher.waitForFinished();
+    qDeleteAll(d->m_parsedEntries);
+    delete d;
+}
+
+DesktopEntryIndex* DesktopEntryIndex::instance()
+{
+    static DesktopEntryIndex index;
+    return &index;
+}
+
+QStringList DesktopEntryIndex::applicationDirs() const
+{
+    return d->m_applicationDirs;
+}
+
+QString DesktopEntryIndex::path(const QString& desktopId) const
+{
+    return d->m_pathForId.value(desktopId);
+}
+
+QString DesktopEntryIndex::desktopId(const QString& path) const
+{
+    return d->m_idForPath.value(path);
+}
+
+GDesktopAppInfo* DesktopEntryIndex::appInfo(const QString& path)
+{
+    ParsedEntry* entry = d->parsedEntry(path);
+    if (entry == NULL || entry->appInfo.isNull()) {
+        return NULL;
+    }
+    return G_DESKTOP_APP_INFO(g_object_ref(entry->appInfo.data()));
+}
+
+IndicatorDesktopShortcuts* DesktopEntryIndex::staticShortcuts(const QString& path)
+{
+    ParsedEntry* entry = d->parsedEntry(path);
+    if (entry == NULL) {
+        return NULL;
+    }
+    if (!entry->shortcutsLoaded) {
+        entry->shortcuts.reset(indicator_desktop_shortcuts_new(QFile::encodeName(path).constData(), "Unity"));
+        entry->shortcutsLoaded = true;
+    }
+    if (entry->shortcuts.isNull()) {
+        return NULL;
+    }
+    return INDICATOR_DESKTOP_SHORTCUTS(g_object_ref(entry->shortcuts.data()));
+}
+
+int DesktopEntryIndex::scanCount() const
+{
+    return d->m_scanCount;
+}
+
+int DesktopEntryIndex::parseCount() const
+{
+    return d->m_parseCount;
+}
+
+void DesktopEntryIndex::onDirectoryChanged()
+{
+    d->m_rescanTimer.start();
+}
+
+void DesktopEntryIndex::rescan()
+{
+    d->startScan();
+}
+
+void DesktopEntryIndex::onScanFinished()
+{
+    const bool entriesChanged = d->applyScan();
+    if (d->m_rescanPending) {
+        /* The directories changed while they were being scanned */
+        d->startScan();
+    }
+    if (entriesChanged) {
+        UQ_DEBUG << "Desktop entries changed," << d->m_pathForId.count() << "entries";
+        Q_EMIT changed();
+    }
+}
+
+#include "desktopentryindex.moc"
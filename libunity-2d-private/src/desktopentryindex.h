@@ -0,0 +1,108 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef DESKTOPENTRYINDEX_H
+#define DESKTOPENTRYINDEX_H
+
+// Qt
+#include <QObject>
+#include <QStringList>
+
+struct _GDesktopAppInfo;
+struct _IndicatorDesktopShortcuts;
+
+class DesktopEntryIndexPrivate;
+/**
+ * Index of the desktop entries installed in the XDG applications directories.
+ *
+ * Desktop ids (e.g. "wine-Programs-Foo-bar.desktop" for
+ * "applications/wine/Programs/Foo/bar.desktop") are resolved to paths with a
+ * hash lookup instead of letting GIO rescan the data directories for each
+ * '-' to '/' substitution. The directories are scanned in worker threads
+ * when the index is first used, so that the GUI thread does not wait on the
+ * disk, and watched afterwards so that installed and removed entries are
+ * picked up. The index is empty until the first scan finishes: callers must
+ * be ready for lookups to fail and listen to changed().
+ *
+ * The parsed GDesktopAppInfo and static shortcuts of an entry are kept and
+ * shared between callers until the file changes on disk.
+ */
+class DesktopEntryIndex : public QObject
+{
+    Q_OBJECT
+public:
+    ~DesktopEntryIndex();
+
+    static DesktopEntryIndex* instance();
+
+    /**
+     * Returns the applications directories, by order of precedence
+     */
+    QStringList applicationDirs() const;
+
+    /**
+     * Returns the path of the desktop entry with @p desktopId, or an empty
+     * string if there is none
+     */
+    QString path(const QString& desktopId) const;
+
+    /**
+     * Returns the desktop id of the entry at @p path, or an empty string if
+     * @p path is not indexed or is shadowed by an entry with the same id in a
+     * directory taking precedence
+     */
+    QString desktopId(const QString& path) const;
+
+    /**
+     * Returns a new reference to the app info of the entry at @p path, or NULL
+     * if it cannot be parsed
+     */
+    struct _GDesktopAppInfo* appInfo(const QString& path);
+
+    /**
+     * Returns a new reference to the static shortcuts (quicklist entries) of
+     * the entry at @p path, or NULL
+     */
+    struct _IndicatorDesktopShortcuts* staticShortcuts(const QString& path);
+
+    /**
+     * Number of directory scans and desktop file parsings since startup, for
+     * testing purpose
+     */
+    int scanCount() const;
+    int parseCount() const;
+
+Q_SIGNALS:
+    /**
+     * Emitted when entries have been added to or removed from the index,
+     * including when the first scan finishes
+     */
+    void changed();
+
+private Q_SLOTS:
+    void onDirectoryChanged();
+    void rescan();
+    void onScanFinished();
+
+private:
+    DesktopEntryIndex();
+    Q_DISABLE_COPY(DesktopEntryIndex)
+    // Use a pimpl to avoid the need for gio includes here
+    DesktopEntryIndexPrivate* const d;
+};
+
+#endif /* DESKTOPENTRYINDEX_H */
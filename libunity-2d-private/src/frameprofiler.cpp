@@ -0,0 +1,205 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "frameprofiler.h"
+
+// Local
+#include "unity2dmetrics.h"
+
+// Qt
+#include <QGraphicsObject>
+#include <QGraphicsView>
+#include <QHash>
+#include <QPainter>
+#include <QStringList>
+
+static const char* FRAME_PROFILER_ENV = "UNITY2D_FRAME_PROFILER";
+
+// Frames further apart than that are not part of the same animation
+static const qint64 MAX_FRAME_INTERVAL = 1000000;
+
+static const int OVERLAY_UPDATE_INTERVAL = 500;
+
+FrameProfiler::Flags FrameProfiler::s_flags =
+    FrameProfiler::parseFlags(QString::fromLocal8Bit(qgetenv(FRAME_PROFILER_ENV)));
+
+static QList<FrameProfiler*> s_profilers;
+
+static QList<qint64> dirtyAreaBounds()
+{
+    return QList<qint64>() << 1 << 5 << 10 << 25 << 50 << 75 << 99;
+}
+
+FrameProfiler::FrameProfiler(QGraphicsView* view)
+: QObject(view)
+, m_view(view)
+, m_dirtyPercent(0)
+, m_framesInSecond(0)
+, m_maxPaintInSecond(0)
+{
+    m_overlayTimer.setInterval(OVERLAY_UPDATE_INTERVAL);
+    connect(&m_overlayTimer, SIGNAL(timeout()), SLOT(updateOverlay()));
+    s_profilers.append(this);
+    applyFlags();
+}
+
+FrameProfiler::~FrameProfiler()
+{
+    s_profilers.removeOne(this);
+}
+
+FrameProfiler::Flags FrameProfiler::flags()
+{
+    return s_flags;
+}
+
+void FrameProfiler::setFlags(Flags flags)
+{
+    if (flags == s_flags) {
+        return;
+    }
+    s_flags = flags;
+    Q_FOREACH(FrameProfiler* profiler, s_profilers) {
+        profiler->applyFlags();
+    }
+}
+
+FrameProfiler::Flags FrameProfiler::parseFlags(const QString& string)
+{
+    Flags flags;
+    Q_FOREACH(const QString& flag, string.split(',', QString::SkipEmptyParts)) {
+        if (flag == "items") {
+            flags |= Frames | Items;
+        } else if (flag == "overlay") {
+            flags |= Frames | Overlay;
+        } else {
+            flags |= Frames;
+        }
+    }
+    return flags;
+}
+
+void FrameProfiler::applyFlags()
+{
+    /* Without indirect painting QGraphicsView paints all the items in one go,
+       and there is no way to time them separately */
+    m_view->setOptimizationFlag(QGraphicsView::IndirectPainting, s_flags.testFlag(Items));
+
+    if (s_flags & Overlay) {
+        m_secondTimer.start();
+        m_overlayTimer.start();
+    } else {
+        m_overlayTimer.stop();
+        m_overlayText.clear();
+    }
+    m_intervalTimer.invalidate();
+    m_view->viewport()->update();
+}
+
+void FrameProfiler::beginFrame(const QRegion& dirtyRegion)
+{
+    if (!isEnabled()) {
+        return;
+    }
+
+    if (m_intervalTimer.isValid()) {
+        const qint64 interval = m_intervalTimer.nsecsElapsed() / 1000;
+        if (interval < MAX_FRAME_INTERVAL) {
+            UQ_METRIC_RECORD("frame.interval", interval);
+        }
+    }
+    m_intervalTimer.start();
+
+    qint64 dirtyArea = 0;
+    Q_FOREACH(const QRect& rect, dirtyRegion.rects()) {
+        dirtyArea += qint64(rect.width()) * rect.height();
+    }
+    const qint64 viewArea = qint64(m_view->viewport()->width()) * m_view->viewport()->height();
+    m_dirtyPercent = viewArea > 0 ? qMin<qint64>(100, dirtyArea * 100 / viewArea) : 0;
+    static Unity2dMetrics::Histogram* dirtyAreaHistogram =
+        Unity2dMetrics::instance()->histogram("frame.dirty_area", dirtyAreaBounds());
+    dirtyAreaHistogram->record(m_dirtyPercent);
+
+    m_paintTimer.start();
+}
+
+void FrameProfiler::endFrame()
+{
+    if (!isEnabled() || !m_paintTimer.isValid()) {
+        return;
+    }
+    const qint64 paintTime = m_paintTimer.nsecsElapsed() / 1000;
+    m_paintTimer.invalidate();
+    UQ_METRIC_RECORD("frame.paint", paintTime);
+
+    if (s_flags & Overlay) {
+        ++m_framesInSecond;
+        m_maxPaintInSecond = qMax(m_maxPaintInSecond, paintTime);
+        if (m_secondTimer.elapsed() >= 1000) {
+            m_overlayText = QString("%1 fps  max paint %2 ms  dirty %3%")
+                .arg(m_framesInSecond)
+                .arg(m_maxPaintInSecond / 1000.0, 0, 'f', 1)
+                .arg(m_dirtyPercent);
+            m_framesInSecond = 0;
+            m_maxPaintInSecond = 0;
+            m_secondTimer.start();
+        }
+    }
+}
+
+void FrameProfiler::addItemTime(QGraphicsItem* item, qint64 microseconds)
+{
+    static QHash<const QMetaObject*, Unity2dMetrics::Histogram*> histograms;
+
+    QGraphicsObject* object = item->toGraphicsObject();
+    const QMetaObject* metaObject = object != NULL ? object->metaObject() : &QGraphicsObject::staticMetaObject;
+    Unity2dMetrics::Histogram*& histogram = histograms[metaObject];
+    if (histogram == NULL) {
+        const QByteArray name = QByteArray("frame.item.") + metaObject->className();
+        histogram = Unity2dMetrics::instance()->histogram(name.constData());
+    }
+    histogram->record(microseconds);
+}
+
+void FrameProfiler::drawOverlay(QPainter* painter)
+{
+    if (!(s_flags & Overlay) || m_overlayText.isEmpty()) {
+        return;
+    }
+    painter->save();
+    painter->resetTransform();
+    const QFontMetrics metrics = painter->fontMetrics();
+    m_overlayRect = QRect(0, 0, metrics.width(m_overlayText) + 8, metrics.height() + 4);
+    painter->fillRect(m_overlayRect, QColor(0, 0, 0, 180));
+    painter->setPen(Qt::white);
+    painter->drawText(m_overlayRect, Qt::AlignCenter, m_overlayText);
+    painter->restore();
+}
+
+void FrameProfiler::updateOverlay()
+{
+    /* Keeps the figures fresh when nothing else repaints; these updates show
+       up in the measures as two small frames per second */
+    if (m_overlayRect.isEmpty()) {
+        m_view->viewport()->update();
+    } else {
+        m_view->viewport()->update(m_overlayRect);
+    }
+}
+
+#include "frameprofiler.moc"
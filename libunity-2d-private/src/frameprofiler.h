@@ -0,0 +1,97 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FRAMEPROFILER_H
+#define FRAMEPROFILER_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QObject>
+#include <QRect>
+#include <QTimer>
+
+class QGraphicsItem;
+class QGraphicsView;
+class QPainter;
+class QRegion;
+
+/**
+ * Measures the frames painted by a Unity2DDeclarativeView, to find out why an
+ * animation stutters without needing a debug build.
+ *
+ * It is disabled by default. Set UNITY2D_FRAME_PROFILER to a comma separated
+ * list of flags, or call SetFlags on the /FrameProfiler D-Bus object:
+ * - "frames": time between frames, paint time and dirty area of each frame
+ * - "items": paint time per item type, this makes painting slower
+ * - "overlay": draws the figures of the last second on top of each view
+ * Any other non-empty value means "frames".
+ *
+ * The measures are recorded as Unity2dMetrics histograms: frame.interval and
+ * frame.paint in microseconds, frame.dirty_area in percents of the view and
+ * frame.item.<class name> in microseconds.
+ */
+class FrameProfiler : public QObject
+{
+    Q_OBJECT
+public:
+    enum Flag {
+        Frames = 0x1,
+        Items = 0x2,
+        Overlay = 0x4
+    };
+    Q_DECLARE_FLAGS(Flags, Flag)
+
+    FrameProfiler(QGraphicsView* view);
+    ~FrameProfiler();
+
+    static Flags flags();
+    static void setFlags(Flags flags);
+    static Flags parseFlags(const QString& flags);
+
+    bool isEnabled() const { return s_flags != 0; }
+    bool profilesItems() const { return s_flags.testFlag(Items); }
+
+    void beginFrame(const QRegion& dirtyRegion);
+    void endFrame();
+    void addItemTime(QGraphicsItem* item, qint64 microseconds);
+    void drawOverlay(QPainter* painter);
+
+private Q_SLOTS:
+    void updateOverlay();
+
+private:
+    void applyFlags();
+
+    static Flags s_flags;
+
+    QGraphicsView* m_view;
+    QElapsedTimer m_paintTimer;
+    QElapsedTimer m_intervalTimer;
+    int m_dirtyPercent;
+
+    // Figures of the current second, shown by the overlay
+    QElapsedTimer m_secondTimer;
+    int m_framesInSecond;
+    qint64 m_maxPaintInSecond;
+    QString m_overlayText;
+    QRect m_overlayRect;
+    QTimer m_overlayTimer;
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(FrameProfiler::Flags)
+
+#endif /* FRAMEPROFILER_H */
@@ -0,0 +1,52 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "frameprofilerdbus.h"
+
+// Local
+#include "frameprofiler.h"
+
+// libunity-2d
+#include <debug_p.h>
+
+// Qt
+#include <QDBusConnection>
+
+static const char* FRAME_PROFILER_DBUS_OBJECT_PATH = "/FrameProfiler";
+
+FrameProfilerDBus::FrameProfilerDBus(QObject* parent)
+: QObject(parent)
+{
+}
+
+bool FrameProfilerDBus::connectToBus()
+{
+    bool ok = QDBusConnection::sessionBus().registerObject(FRAME_PROFILER_DBUS_OBJECT_PATH, this,
+                                                           QDBusConnection::ExportAllSlots);
+    if (!ok) {
+        UQ_WARNING << "The object" << FRAME_PROFILER_DBUS_OBJECT_PATH << "is already present on DBUS.";
+    }
+    return ok;
+}
+
+void FrameProfilerDBus::SetFlags(const QString& flags)
+{
+    FrameProfiler::setFlags(FrameProfiler::parseFlags(flags));
+}
+
+#include "frameprofilerdbus.moc"
@@ -0,0 +1,50 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FRAMEPROFILERDBUS_H
+#define FRAMEPROFILERDBUS_H
+
+// Qt
+#include <QObject>
+
+/**
+ * D-Bus switch of the frame profiler of the declarative views, exported as
+ * /FrameProfiler next to /Metrics, which stays read-only.
+ */
+class FrameProfilerDBus : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.canonical.Unity2d.FrameProfiler")
+
+public:
+    FrameProfilerDBus(QObject* parent = 0);
+
+    /**
+     * Registers the object on the session bus, under the names the process
+     * already owns
+     */
+    bool connectToBus();
+
+public Q_SLOTS:
+    /**
+     * Switches the frame profiler, see FrameProfiler for the flags. An empty
+     * string disables it.
+     */
+    void SetFlags(const QString& flags);
+};
+
+#endif /* FRAMEPROFILERDBUS_H */
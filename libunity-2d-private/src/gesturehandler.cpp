@@ -21,16 +21,32 @@
 
 #include <QX11Info>
 #include <QSocketNotifier>
-#include <QDBusInterface>
+#include <QDBusConnection>
+#include <QDBusMessage>
+#include <QTimer>
 
 #include <debug_p.h>
 
+/* Drag updates are reported at most once per frame */
+static const int DRAG_UPDATE_INTERVAL = 16;
+
 GestureHandler::GestureHandler(QObject *parent)
 : QObject(parent)
 , m_geisInstance(NULL)
-, m_isDragging(false)
+, m_dragDeltaTimer(new QTimer(this))
 , m_dashManager(NULL)
 {
+    m_dragDeltaTimer->setInterval(DRAG_UPDATE_INTERVAL);
+    m_dragDeltaTimer->setSingleShot(true);
+    connect(m_dragDeltaTimer, SIGNAL(timeout()), SLOT(emitDragDeltaChanged()));
+
+    connect(&m_interpreter, SIGNAL(toggleDashRequested()), SLOT(toggleDash()));
+    connect(&m_interpreter, SIGNAL(spreadZoomInRequested()), SLOT(spreadZoomIn()));
+    connect(&m_interpreter, SIGNAL(spreadZoomOutRequested()), SLOT(spreadZoomOut()));
+    connect(&m_interpreter, SIGNAL(dragStarted()), SLOT(onDragStarted()));
+    connect(&m_interpreter, SIGNAL(dragDeltaChanged(float)), SLOT(onDragDeltaChanged()));
+    connect(&m_interpreter, SIGNAL(dragFinished()), SLOT(onDragFinished()));
+
     if (geisInitialize() != GEIS_STATUS_SUCCESS) {
         UQ_WARNING << "GEIS initialization failed: multitouch support disabled";
         return;
@@ -118,26 +134,33 @@ GeisStatus GestureHandler::geisSubscribeGestures()
                           &m_gestureFuncs, this);
 }
 
-/* FIXME: zooming in/out in the spread should have 3 levels:
-    1) showing all windows of the focused application in the current workspace
-    2) showing all windows in the current workspace
-    3) showing all windows in all workspaces
-
-    This will require changes to the workspace switcher (spread) to advertise its current state over D-Bus.
-*/
-static void spreadZoomIn()
+/* Requests to the spread are sent without waiting for a reply so that a
+   busy or missing spread never stalls gesture processing */
+static void callSpread(const QString& method, const QVariantList& arguments = QVariantList())
 {
-    QDBusInterface spreadInterface("com.canonical.Unity2d.Spread", "/Spread", "com.canonical.Unity2d.Spread");
-    spreadInterface.call(QDBus::Block, "Hide");
+    QDBusMessage message = QDBusMessage::createMethodCall("com.canonical.Unity2d.Spread",
+        "/Spread", "com.canonical.Unity2d.Spread", method);
+    message.setArguments(arguments);
+    QDBusConnection::sessionBus().send(message);
 }
 
-static void spreadZoomOut()
+void GestureHandler::spreadZoomIn()
 {
-    QDBusInterface spreadInterface("com.canonical.Unity2d.Spread", "/Spread", "com.canonical.Unity2d.Spread");
-    spreadInterface.call(QDBus::Block, "ShowAllWorkspaces", "");
+    callSpread("Hide");
 }
 
+void GestureHandler::spreadZoomOut()
+{
+    callSpread("ShowAllWorkspaces", QVariantList() << QString());
+}
 
+void GestureHandler::toggleDash()
+{
+    Q_ASSERT(m_dashManager != NULL);
+    if (m_dashManager != NULL) {
+        QMetaObject::invokeMethod(m_dashManager, "toggleDashRequested", Qt::QueuedConnection);
+    }
+}
 
 /* Return a dictionary of attribute name -> attribute value */
 QHash<QString, GeisGestureAttr> GestureHandler::parseGestureAttributes(GeisSize attr_count, GeisGestureAttr *attrs)
@@ -157,125 +180,88 @@ QHash<QString, GeisGestureAttr> GestureHandler::parseGestureAttributes(GeisSize
 
 /* Static methods used as callbacks for GEIS and that only forward the call to
    non static methods of the GestureHandler instance passed as first parameter */
-void GestureHandler::staticGestureStart(void *gestureHandler, GeisGestureType type, GeisGestureId id,
+void GestureHandler::staticGestureStart(void *gestureHandler, GeisGestureType /*type*/, GeisGestureId /*id*/,
                                         GeisSize attr_count, GeisGestureAttr *attrs)
 {
     QHash<QString, GeisGestureAttr> attributes = parseGestureAttributes(attr_count, attrs);
-    ((GestureHandler*)gestureHandler)->gestureStart(type, id, attributes);
+    ((GestureHandler*)gestureHandler)->processGesture(GestureEvent::Start, attributes);
 }
 
-void GestureHandler::staticGestureUpdate(void *gestureHandler, GeisGestureType type, GeisGestureId id,
+void GestureHandler::staticGestureUpdate(void *gestureHandler, GeisGestureType /*type*/, GeisGestureId /*id*/,
                                          GeisSize attr_count, GeisGestureAttr *attrs)
 {
     QHash<QString, GeisGestureAttr> attributes = parseGestureAttributes(attr_count, attrs);
-    ((GestureHandler*)gestureHandler)->gestureUpdate(type, id, attributes);
+    ((GestureHandler*)gestureHandler)->processGesture(GestureEvent::Update, attributes);
 }
 
-void GestureHandler::staticGestureFinish(void *gestureHandler, GeisGestureType type, GeisGestureId id,
+void GestureHandler::staticGestureFinish(void *gestureHandler, GeisGestureType /*type*/, GeisGestureId /*id*/,
                                          GeisSize attr_count, GeisGestureAttr *attrs)
 {
     QHash<QString, GeisGestureAttr> attributes = parseGestureAttributes(attr_count, attrs);
-    ((GestureHandler*)gestureHandler)->gestureFinish(type, id, attributes);
+    ((GestureHandler*)gestureHandler)->processGesture(GestureEvent::Finish, attributes);
 }
 
-
-/* Gesture event handlers */
-void GestureHandler::gestureStart(GeisGestureType type, GeisGestureId id,
-                                  QHash<QString, GeisGestureAttr> attributes)
+/* Convert GEIS attributes to a GestureEvent and hand it to the interpreter */
+void GestureHandler::processGesture(GestureEvent::Phase phase,
+                                    const QHash<QString, GeisGestureAttr>& attributes)
 {
-    QString gestureName = attributes[GEIS_GESTURE_ATTRIBUTE_GESTURE_NAME].string_val;
-
-    if (gestureName == GEIS_GESTURE_TYPE_PINCH3) {
-        /* 3 fingers pinch inwards shows the workspace switcher (zoom out showing all workspaces)
-           3 fingers pinch outwards (also called 'spread' by designers) hides the workspace switcher (zoom in a workspace)
-         */
-        float radiusDelta = attributes[GEIS_GESTURE_ATTRIBUTE_RADIUS_DELTA].float_val;
-        if (radiusDelta < 0) {
-            spreadZoomOut();
-        } else if (radiusDelta > 0) {
-            spreadZoomIn();
-        }
-
-        m_pinchPreviousRadius = attributes[GEIS_GESTURE_ATTRIBUTE_RADIUS].float_val;
-        m_pinchPreviousTimestamp = attributes[GEIS_GESTURE_ATTRIBUTE_TIMESTAMP].integer_val;
+    QString gestureName = attributes.value(GEIS_GESTURE_ATTRIBUTE_GESTURE_NAME).string_val;
+
+    GestureEvent event;
+    event.phase = phase;
+    if (gestureName == GEIS_GESTURE_TYPE_TAP4) {
+        event.type = GestureEvent::Tap4;
+    } else if (gestureName == GEIS_GESTURE_TYPE_PINCH3) {
+        event.type = GestureEvent::Pinch3;
+        event.timestamp = attributes.value(GEIS_GESTURE_ATTRIBUTE_TIMESTAMP).integer_val;
+        event.radius = attributes.value(GEIS_GESTURE_ATTRIBUTE_RADIUS).float_val;
+        event.radiusDelta = attributes.value(GEIS_GESTURE_ATTRIBUTE_RADIUS_DELTA).float_val;
     } else if (gestureName == GEIS_GESTURE_TYPE_DRAG4) {
-        /* 4 fingers drag reveals the launcher progressively; if the drag goes far
-           enough, the launcher is then locked in place and does not autohide anymore */
-        /* FIXME: only supports the launcher positioned on the left edge of the screen */
-        m_isDragging = true;
-        Q_EMIT isDraggingChanged();
-        m_dragDelta = attributes[GEIS_GESTURE_ATTRIBUTE_DELTA_X].float_val;
-        Q_EMIT dragDeltaChanged();
+        event.type = GestureEvent::Drag4;
+        event.deltaX = attributes.value(GEIS_GESTURE_ATTRIBUTE_DELTA_X).float_val;
+    } else {
+        return;
     }
+
+    m_interpreter.processEvent(event);
 }
 
-void GestureHandler::gestureUpdate(GeisGestureType type, GeisGestureId id,
-                                   QHash<QString, GeisGestureAttr> attributes)
+void GestureHandler::onDragStarted()
 {
-    QString gestureName = attributes[GEIS_GESTURE_ATTRIBUTE_GESTURE_NAME].string_val;
+    Q_EMIT isDraggingChanged();
+}
 
-    if (gestureName == GEIS_GESTURE_TYPE_TAP4) {
-        /* 4 fingers tap toggles the dash on and off */
-        Q_ASSERT(m_dashManager != NULL);
-        if (m_dashManager != NULL) {
-            QMetaObject::invokeMethod(m_dashManager, "toggleDashRequested");
-        }
-    } else if (gestureName == GEIS_GESTURE_TYPE_PINCH3) {
-        /* Continuing a 3 fingers pinch inwards/outwards shows/hides the workspace switcher. */
-        int timestamp = attributes[GEIS_GESTURE_ATTRIBUTE_TIMESTAMP].integer_val;
-        float radius = attributes[GEIS_GESTURE_ATTRIBUTE_RADIUS].float_val;
-
-        /* Ignore pinch events that are too close in time from the previous
-           pinching event that triggered an action as they are likely to be a
-           continuation part of the previous pinch event.
-        */
-        if (timestamp - m_pinchPreviousTimestamp < 500) {
-            m_pinchPreviousRadius = radius;
-            m_pinchPreviousTimestamp = timestamp;
-            return;
-        }
-
-        /* For the pinch event to trigger an action the difference in radius between
-           the current pinch event and the last pinch event that triggered an action
-           has to be enough as to not be over sensitive and to not trigger actions for
-           any small movement of the user's fingers.
-        */
-        if (radius - m_pinchPreviousRadius > 30) {
-            spreadZoomIn();
-            m_pinchPreviousRadius = radius;
-            m_pinchPreviousTimestamp = timestamp;
-        } else if (radius - m_pinchPreviousRadius < -30) {
-            spreadZoomOut();
-            m_pinchPreviousRadius = radius;
-            m_pinchPreviousTimestamp = timestamp;
-        }
-    } else if (gestureName == GEIS_GESTURE_TYPE_DRAG4) {
-        m_dragDelta += attributes[GEIS_GESTURE_ATTRIBUTE_DELTA_X].float_val;
-        Q_EMIT dragDeltaChanged();
+void GestureHandler::onDragDeltaChanged()
+{
+    /* Coalesce the updates received during a frame */
+    if (!m_dragDeltaTimer->isActive()) {
+        m_dragDeltaTimer->start();
     }
 }
 
-void GestureHandler::gestureFinish(GeisGestureType type, GeisGestureId id,
-                                   QHash<QString, GeisGestureAttr> attributes)
+void GestureHandler::onDragFinished()
 {
-    QString gestureName = attributes[GEIS_GESTURE_ATTRIBUTE_GESTURE_NAME].string_val;
-
-    if (gestureName == GEIS_GESTURE_TYPE_DRAG4) {
-        m_dragDelta += attributes[GEIS_GESTURE_ATTRIBUTE_DELTA_X].float_val;
-        Q_EMIT dragDeltaChanged();
-        m_isDragging = false;
-        Q_EMIT isDraggingChanged();
+    /* Flush the pending update before announcing the end of the drag */
+    if (m_dragDeltaTimer->isActive()) {
+        m_dragDeltaTimer->stop();
+        emitDragDeltaChanged();
     }
+    Q_EMIT isDraggingChanged();
+}
+
+void GestureHandler::emitDragDeltaChanged()
+{
+    Q_EMIT dragDeltaChanged();
 }
 
 double GestureHandler::dragDelta() const
 {
-    return m_dragDelta;
+    return m_interpreter.dragDelta();
 }
 
 bool GestureHandler::isDragging() const
 {
-    return m_isDragging;
+    return m_interpreter.state() == GestureInterpreter::Dragging;
 }
 
 QObject *GestureHandler::dashManager() const
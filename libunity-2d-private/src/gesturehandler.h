@@ -28,6 +28,10 @@ extern "C" {
   #include <geis/geis.h>
 }
 
+#include "gestureinterpreter.h"
+
+class QTimer;
+
 class GestureHandler : public QObject
 {
     Q_OBJECT
@@ -51,6 +55,13 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void geisEventDispatch();
+    void onDragStarted();
+    void onDragFinished();
+    void onDragDeltaChanged();
+    void emitDragDeltaChanged();
+    void toggleDash();
+    void spreadZoomIn();
+    void spreadZoomOut();
 
 private:
     GeisStatus geisInitialize();
@@ -64,16 +75,12 @@ private:
                                     GeisSize attr_count, GeisGestureAttr *attrs);
     static void staticGestureFinish(void *gestureHandler, GeisGestureType type, GeisGestureId id,
                                     GeisSize attr_count, GeisGestureAttr *attrs);
-    void gestureStart(GeisGestureType type, GeisGestureId id, QHash<QString, GeisGestureAttr> attributes);
-    void gestureUpdate(GeisGestureType type, GeisGestureId id, QHash<QString, GeisGestureAttr> attributes);
-    void gestureFinish(GeisGestureType type, GeisGestureId id, QHash<QString, GeisGestureAttr> attributes);
+    void processGesture(GestureEvent::Phase phase, const QHash<QString, GeisGestureAttr>& attributes);
 
     GeisInstance m_geisInstance;
     GeisGestureFuncs m_gestureFuncs;
-    float m_pinchPreviousRadius;
-    int m_pinchPreviousTimestamp;
-    float m_dragDelta;
-    bool m_isDragging;
+    GestureInterpreter m_interpreter;
+    QTimer *m_dragDeltaTimer;
     QObject *m_dashManager;
 };
 
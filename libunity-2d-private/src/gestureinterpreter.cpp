@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2012 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gestureinterpreter.h"
+
+/* Pinch events closer than this to the one which triggered an action are
+   considered part of the same pinch */
+static const int PINCH_CONTINUATION_INTERVAL = 500;
+
+/* Minimal radius change for a pinch to trigger an action */
+static const float PINCH_RADIUS_THRESHOLD = 30;
+
+GestureInterpreter::GestureInterpreter(QObject *parent)
+: QObject(parent)
+, m_pinching(false)
+, m_dragging(false)
+, m_pinchPreviousRadius(0)
+, m_pinchPreviousTimestamp(0)
+, m_dragDelta(0)
+{
+}
+
+GestureInterpreter::State GestureInterpreter::state() const
+{
+    if (m_dragging) {
+        return Dragging;
+    } else if (m_pinching) {
+        return Pinching;
+    }
+    return Idle;
+}
+
+float GestureInterpreter::dragDelta() const
+{
+    return m_dragDelta;
+}
+
+void GestureInterpreter::processEvent(const GestureEvent &event)
+{
+    switch (event.type) {
+    case GestureEvent::Tap4:
+        /* 4 fingers tap toggles the dash on and off */
+        if (event.phase == GestureEvent::Update) {
+            Q_EMIT toggleDashRequested();
+        }
+        break;
+    case GestureEvent::Pinch3:
+        processPinch(event);
+        break;
+    case GestureEvent::Drag4:
+        processDrag(event);
+        break;
+    }
+}
+
+/* FIXME: zooming in/out in the spread should have 3 levels:
+    1) showing all windows of the focused application in the current workspace
+    2) showing all windows in the current workspace
+    3) showing all windows in all workspaces
+
+    This will require changes to the workspace switcher (spread) to advertise its current state over D-Bus.
+*/
+void GestureInterpreter::processPinch(const GestureEvent &event)
+{
+    switch (event.phase) {
+    case GestureEvent::Start:
+        /* 3 fingers pinch inwards shows the workspace switcher (zoom out showing all workspaces)
+           3 fingers pinch outwards (also called 'spread' by designers) hides the workspace switcher (zoom in a workspace)
+         */
+        if (event.radiusDelta < 0) {
+            Q_EMIT spreadZoomOutRequested();
+        } else if (event.radiusDelta > 0) {
+            Q_EMIT spreadZoomInRequested();
+        }
+        m_pinchPreviousRadius = event.radius;
+        m_pinchPreviousTimestamp = event.timestamp;
+        m_pinching = true;
+        break;
+    case GestureEvent::Update:
+        /* Ignore pinch events that are too close in time from the previous
+           pinching event that triggered an action as they are likely to be a
+           continuation part of the previous pinch event.
+        */
+        if (event.timestamp - m_pinchPreviousTimestamp < PINCH_CONTINUATION_INTERVAL) {
+            m_pinchPreviousRadius = event.radius;
+            m_pinchPreviousTimestamp = event.timestamp;
+            return;
+        }
+
+        /* For the pinch event to trigger an action the difference in radius between
+           the current pinch event and the last pinch event that triggered an action
+           has to be enough as to not be over sensitive and to not trigger actions for
+           any small movement of the user's fingers.
+        */
+        if (event.radius - m_pinchPreviousRadius > PINCH_RADIUS_THRESHOLD) {
+            Q_EMIT spreadZoomInRequested();
+            m_pinchPreviousRadius = event.radius;
+            m_pinchPreviousTimestamp = event.timestamp;
+        } else if (event.radius - m_pinchPreviousRadius < -PINCH_RADIUS_THRESHOLD) {
+            Q_EMIT spreadZoomOutRequested();
+            m_pinchPreviousRadius = event.radius;
+            m_pinchPreviousTimestamp = event.timestamp;
+        }
+        break;
+    case GestureEvent::Finish:
+        m_pinching = false;
+        break;
+    }
+}
+
+void GestureInterpreter::processDrag(const GestureEvent &event)
+{
+    /* 4 fingers drag reveals the launcher progressively; if the drag goes far
+       enough, the launcher is then locked in place and does not autohide anymore */
+    /* FIXME: only supports the launcher positioned on the left edge of the screen */
+    switch (event.phase) {
+    case GestureEvent::Start:
+        m_dragDelta = event.deltaX;
+        m_dragging = true;
+        Q_EMIT dragStarted();
+        Q_EMIT dragDeltaChanged(m_dragDelta);
+        break;
+    case GestureEvent::Update:
+        m_dragDelta += event.deltaX;
+        Q_EMIT dragDeltaChanged(m_dragDelta);
+        break;
+    case GestureEvent::Finish:
+        m_dragDelta += event.deltaX;
+        Q_EMIT dragDeltaChanged(m_dragDelta);
+        m_dragging = false;
+        Q_EMIT dragFinished();
+        break;
+    }
+}
+
+#include "gestureinterpreter.moc"
@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2012 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef GESTUREINTERPRETER_H
+#define GESTUREINTERPRETER_H
+
+#include <QObject>
+
+/**
+ * A gesture event, as decoded from GEIS by GestureHandler
+ */
+struct GestureEvent
+{
+    enum Phase {
+        Start,
+        Update,
+        Finish
+    };
+
+    enum Type {
+        Tap4,
+        Pinch3,
+        Drag4
+    };
+
+    GestureEvent()
+    : phase(Start), type(Tap4), timestamp(0), radius(0), radiusDelta(0), deltaX(0)
+    {}
+
+    Phase phase;
+    Type type;
+    int timestamp;
+    float radius;
+    float radiusDelta;
+    float deltaX;
+};
+
+/**
+ * Maps gesture events to shell actions.
+ *
+ * This does not depend on GEIS so that recorded gesture traces can be
+ * replayed without touch hardware.
+ */
+class GestureInterpreter : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum State {
+        Idle,
+        Pinching,
+        Dragging
+    };
+
+    explicit GestureInterpreter(QObject *parent = 0);
+
+    /* Dragging takes precedence over Pinching when both are in progress */
+    State state() const;
+    float dragDelta() const;
+
+    void processEvent(const GestureEvent &event);
+
+Q_SIGNALS:
+    void toggleDashRequested();
+    void spreadZoomInRequested();
+    void spreadZoomOutRequested();
+    void dragStarted();
+    void dragDeltaChanged(float delta);
+    void dragFinished();
+
+private:
+    void processPinch(const GestureEvent &event);
+    void processDrag(const GestureEvent &event);
+
+    /* Pinches and drags are tracked apart: GEIS may deliver a pinch while a
+       drag is in progress and it must not end the drag */
+    bool m_pinching;
+    bool m_dragging;
+    float m_pinchPreviousRadius;
+    int m_pinchPreviousTimestamp;
+    float m_dragDelta;
+};
+
+#endif // GESTUREINTERPRETER_H
@@ -24,6 +24,7 @@
 
 // Local
 #include <debug_p.h>
+#include <unity2dmetrics.h>
 
 // Qt
 #include <QCoreApplication>
@@ -59,6 +60,7 @@ struct GnomeSessionClientPrivate
             SM_DBUS_SERVICE,
             m_clientPath,
             SM_CLIENT_DBUS_INTERFACE);
+        UQ_METRIC_COUNT("dbus.blocking_calls");
         QDBusReply<void> reply = iface.call("EndSessionResponse", /* is_okay= */ true, /* reason= */ "");
         if (reply.isValid()) {
             return true;
@@ -96,6 +98,7 @@ void GnomeSessionClient::connectToSessionManager()
         QDBusConnection::sessionBus(),
         this);
 
+    UQ_METRIC_COUNT("dbus.calls");
     QDBusPendingCall call = managerIface->asyncCall("RegisterClient", d->m_applicationId, startupId);
     QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(call, this);
     connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)),
@@ -25,6 +25,7 @@
 
 // Local
 #include <debug_p.h>
+#include <unity2dmetrics.h>
 
 // Qt
 #include <QDateTime>
@@ -123,6 +124,7 @@ void Hud::setSearchQuery(const QString& searchQuery)
             m_searchQuery = searchQuery;
             m_unityHud->RequestQuery(m_searchQuery.toStdString());
             m_hudQueryOpen = true;
+            UQ_METRIC_COUNT("model.resets");
             beginResetModel();
             Q_EMIT searchQueryChanged();
         }
@@ -157,6 +159,7 @@ void Hud::endSearch()
         m_hudQueryOpen = false;
     }
     m_searchQuery.clear();
+    UQ_METRIC_COUNT("model.resets");
     beginResetModel();
     m_unityHudResults.clear();
     endResetModel();
@@ -24,6 +24,8 @@
 
 #include <debug_p.h>
 #include <gimageutils.h>
+#include <unity2dmetrics.h>
+#include <unity2dtrace.h>
 
 static const char* UNITY_RES_PATH = "/usr/share/unity/";
 
@@ -41,6 +43,8 @@ IconImageProvider::~IconImageProvider()
 
 QImage IconImageProvider::requestImage(const QString &id, QSize *size, const QSize &requestedSize)
 {
+    UQ_TRACE_SCOPE("IconImageProvider::requestImage");
+    UQ_METRIC_LATENCY("imageprovider.icon.latency");
     /* Special case handling for image resources that belong to the unity
        package. If unity is not installed, as a fallback we rewrite the path to
        try and locate them in our (unity-2d) resource directory.
@@ -25,11 +25,15 @@
 #include <cairoutils.h>
 #include <debug_p.h>
 #include <gscopedpointer.h>
+#include <gconnector.h>
 #include <gimageutils.h>
+#include <labellayoutcache.h>
 #include <panelstyle.h>
 
 // Qt
+#include <QCache>
 #include <QIcon>
+#include <QPair>
 #include <QPainter>
 #include <QWheelEvent>
 
@@ -43,10 +47,62 @@ static const int SPACING = 3;
 static const int PADDING = 5;
 static const int ICON_SIZE = 22;
 
+// Battery, network and sound indicators cycle through a few dozen icons
+static const int ICON_CACHE_MAX_BYTES = 2 * 1024 * 1024;
+
 using namespace unity::indicator;
 
+/**
+ * Keeps decoded indicator icons around, so that an indicator resending the
+ * same image data, or the same entry shown on several panels, does not
+ * decode it again.
+ */
+class IconDecodeCache
+{
+public:
+    static IconDecodeCache* instance()
+    {
+        static IconDecodeCache cache;
+        return &cache;
+    }
+
+    QPixmap pixmap(int type, const std::string& data)
+    {
+        QPixmap* pix = m_cache.object(Key(type, QByteArray::fromRawData(data.c_str(), data.size())));
+        return pix ? *pix : QPixmap();
+    }
+
+    void insert(int type, const std::string& data, const QPixmap& pix)
+    {
+        // Account for the key as well: base64 encoded pixbufs are not small
+        int cost = pix.width() * pix.height() * 4 + data.size();
+        m_cache.insert(Key(type, QByteArray(data.c_str(), data.size())), new QPixmap(pix), cost);
+    }
+
+private:
+    typedef QPair<int, QByteArray> Key;
+
+    IconDecodeCache()
+    : m_cache(ICON_CACHE_MAX_BYTES)
+    {
+        // GIcon strings are resolved using the icon theme
+        m_gConnector.connect(gtk_settings_get_default(), "notify::gtk-icon-theme-name",
+            G_CALLBACK(IconDecodeCache::onIconThemeChanged), this);
+    }
+
+    static void onIconThemeChanged(GObject*, GParamSpec*, IconDecodeCache* obj)
+    {
+        obj->m_cache.clear();
+    }
+
+    QCache<Key, QPixmap> m_cache;
+    GConnector m_gConnector;
+};
+
 IndicatorEntryWidget::IndicatorEntryWidget(const Entry::Ptr& entry)
 : m_entry(entry)
+, m_pixWidth(0)
+, m_labelX(0)
 , m_padding(PADDING)
 , m_hasIcon(false)
 , m_hasLabel(false)
@@ -59,8 +115,12 @@ IndicatorEntryWidget::IndicatorEntryWidget(const Entry::Ptr& entry)
     gtk_widget_path_append_type(m_gtkWidgetPath, GTK_TYPE_MENU_ITEM);
 
     setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Minimum);
-    m_entry->updated.connect(sigc::mem_fun(this, &IndicatorEntryWidget::updatePix));
+    m_entry->updated.connect(sigc::mem_fun(this, &IndicatorEntryWidget::onEntryUpdated));
     m_entry->active_changed.connect(sigc::mem_fun(this, &IndicatorEntryWidget::onActiveChanged));
+    connect(LabelLayoutCache::instance(), SIGNAL(fontChanged()), SLOT(updatePix()));
+    // The theme may change the rendering without changing the palette
+    m_gConnector.connect(gtk_settings_get_default(), "notify::gtk-theme-name",
+        G_CALLBACK(IndicatorEntryWidget::onThemeChanged), this);
 }
 
 IndicatorEntryWidget::~IndicatorEntryWidget()
@@ -121,26 +181,61 @@ void IndicatorEntryWidget::paintActiveBackground(QImage* image)
     gtk_style_context_restore(styleContext);
 }
 
+QByteArray IndicatorEntryWidget::contentKey() const
+{
+    // Everything which affects rendering, except the active state
+    QByteArray key;
+    key.append(m_entry->label().c_str(), m_entry->label().size());
+    key.append('\0');
+    key.append(m_entry->image_data().c_str(), m_entry->image_data().size());
+    key.append('\0');
+    key.append(QByteArray::number(m_entry->image_type()));
+    key.append(m_entry->label_visible() ? '1' : '0');
+    key.append(m_entry->label_sensitive() ? '1' : '0');
+    key.append(m_entry->image_visible() ? '1' : '0');
+    key.append(m_entry->image_sensitive() ? '1' : '0');
+    key.append(m_entry->show_now() ? '1' : '0');
+    return key;
+}
+
+void IndicatorEntryWidget::onThemeChanged(GObject*, GParamSpec*, IndicatorEntryWidget* obj)
+{
+    obj->updatePix();
+}
+
+void IndicatorEntryWidget::onEntryUpdated()
+{
+    // The entry is also updated when its menu is opened or closed, in which
+    // case we only need to switch to another rendered variant
+    QByteArray key = contentKey();
+    if (key == m_contentKey) {
+        updateStatePix();
+        return;
+    }
+    m_contentKey = key;
+    updatePix();
+}
+
 void IndicatorEntryWidget::updatePix()
 {
     bool oldIsEmpty = isEmpty();
 
-    int width = m_padding;
-    int iconX = m_padding;
-    int labelX = 0;
+    for (int state = 0; state < RenderStateCount; ++state) {
+        m_statePix[state] = QPixmap();
+    }
 
-    GObjectScopedPointer<PangoLayout> pangoLayout;
+    int width = m_padding;
 
     // Compute width, labelX and update m_has{Icon,Label}
-    QPixmap iconPix;
     if (m_entry->image_visible()) {
-        iconPix = decodeIcon();
-        m_hasIcon = !iconPix.isNull();
+        m_iconPix = decodeIcon();
+        m_hasIcon = !m_iconPix.isNull();
     } else {
+        m_iconPix = QPixmap();
         m_hasIcon = false;
     }
     if (m_hasIcon) {
-        width += iconPix.width();
+        width += m_iconPix.width();
     }
 
     m_hasLabel = !m_entry->label().empty() && m_entry->label_visible();
@@ -148,8 +243,8 @@ void IndicatorEntryWidget::updatePix()
         if (m_hasIcon) {
             width += SPACING;
         }
-        labelX = width;
-        pangoLayout.reset(createPangoLayout());
+        m_labelX = width;
+        GObjectScopedPointer<PangoLayout> pangoLayout(createPangoLayout());
         int labelWidth;
         int labelHeight;
         pango_layout_get_pixel_size(pangoLayout.data(), &labelWidth, &labelHeight);
@@ -158,33 +253,31 @@ void IndicatorEntryWidget::updatePix()
     }
 
     width += m_padding;
+    m_pixWidth = width;
+
+    updateStatePix();
+
+    bool newIsEmpty = isEmpty();
+    if (newIsEmpty != oldIsEmpty) {
+        // If we emit isEmptyChanged() directly it won't reach any connected
+        // slot. I assume this is because this method is called as a response
+        // to a sigc++ signal.
+        QMetaObject::invokeMethod(this, "isEmptyChanged", Qt::QueuedConnection);
+    }
+}
+
+void IndicatorEntryWidget::updateStatePix()
+{
+    RenderState state = m_activatedByThisEntry ? PrelightRenderState : NormalRenderState;
 
-    // Paint
     QPixmap oldPix = m_pix;
     if (!m_hasIcon && !m_hasLabel) {
         m_pix = QPixmap();
     } else {
-        QImage img(width, height(), QImage::Format_ARGB32_Premultiplied);
-        img.fill(Qt::transparent);
-        QPainter painter(&img);
-        painter.initFrom(this);
-        if (m_activatedByThisEntry) {
-            paintActiveBackground(&img);
-        }
-        if (m_hasIcon) {
-            bool disabled = !m_entry->image_sensitive();
-            if (disabled) {
-                painter.setOpacity(0.5);
-            }
-            painter.drawPixmap(iconX, (height() - iconPix.height()) / 2, iconPix);
-            if (disabled) {
-                painter.setOpacity(1);
-            }
-        }
-        if (m_hasLabel) {
-            paintLabel(&img, pangoLayout.data(), labelX);
+        if (m_statePix[state].isNull()) {
+            m_statePix[state] = renderStatePix(state);
         }
-        m_pix = QPixmap::fromImage(img);
+        m_pix = m_statePix[state];
     }
 
     // Notify others we changed, but only trigger a layout update if necessary
@@ -193,70 +286,50 @@ void IndicatorEntryWidget::updatePix()
     } else {
         updateGeometry();
     }
-    bool newIsEmpty = isEmpty();
-    if (newIsEmpty != oldIsEmpty) {
-        // If we emit isEmptyChanged() directly it won't reach any connected
-        // slot. I assume this is because this method is called as a response
-        // to a sigc++ signal.
-        QMetaObject::invokeMethod(this, "isEmptyChanged", Qt::QueuedConnection);
+}
+
+QPixmap IndicatorEntryWidget::renderStatePix(RenderState state)
+{
+    QImage img(m_pixWidth, height(), QImage::Format_ARGB32_Premultiplied);
+    img.fill(Qt::transparent);
+    QPainter painter(&img);
+    painter.initFrom(this);
+    if (state == PrelightRenderState) {
+        paintActiveBackground(&img);
     }
+    if (m_hasIcon) {
+        bool disabled = !m_entry->image_sensitive();
+        if (disabled) {
+            painter.setOpacity(0.5);
+        }
+        painter.drawPixmap(m_padding, (height() - m_iconPix.height()) / 2, m_iconPix);
+        if (disabled) {
+            painter.setOpacity(1);
+        }
+    }
+    if (m_hasLabel) {
+        GObjectScopedPointer<PangoLayout> pangoLayout(createPangoLayout());
+        paintLabel(&img, pangoLayout.data(), m_labelX, state);
+    }
+    painter.end();
+    return QPixmap::fromImage(img);
 }
 
 void IndicatorEntryWidget::onActiveChanged(bool active)
 {
     if (!active) {
         m_activatedByThisEntry = false;
+        updateStatePix();
     }
 }
 
 PangoLayout* IndicatorEntryWidget::createPangoLayout()
 {
-    // Parse
-    PangoAttrList* attrs = NULL;
-    if (m_entry->show_now()) {
-        if (!pango_parse_markup(m_entry->label().c_str(),
-                                 -1,
-                                 '_',
-                                 &attrs,
-                                 NULL,
-                                 NULL,
-                                 NULL))
-        {
-            UQ_WARNING << "pango_parse_markup failed";
-        }
-    }
-
-    // Create layout
-    GObjectScopedPointer<PangoContext> pangoContext(gdk_pango_context_get());
-    PangoLayout* layout = pango_layout_new(pangoContext.data());
-
-    if (attrs) {
-        pango_layout_set_attributes(layout, attrs);
-        pango_attr_list_unref(attrs);
-    }
-
-    // Set font
-    char* font_description = NULL;
-    GtkSettings *settings = gtk_settings_get_default();
-    g_object_get(settings,
-                  "gtk-font-name", &font_description,
-                  NULL);
-    PangoFontDescription* desc = pango_font_description_from_string(font_description);
-    pango_font_description_set_weight(desc, PANGO_WEIGHT_NORMAL);
-    pango_layout_set_font_description(layout, desc);
-    pango_font_description_free(desc);
-    g_free(font_description);
-
-    // Set text
     QString label = QString::fromUtf8(m_entry->label().c_str());
-    label.replace('_', QString());
-    QByteArray utf8Label = label.toUtf8();
-    pango_layout_set_text(layout, utf8Label.data(), -1);
-
-    return layout;
+    return LabelLayoutCache::instance()->layout(label, m_entry->show_now());
 }
 
-void IndicatorEntryWidget::paintLabel(QImage* image, PangoLayout* layout, int labelX)
+void IndicatorEntryWidget::paintLabel(QImage* image, PangoLayout* layout, int labelX, RenderState state)
 {
     // This code should be kept in sync with corresponding unityshell code from
     // plugins/unityshell/src/PanelIndicatorObjectEntryView.cpp
@@ -275,7 +348,7 @@ void IndicatorEntryWidget::paintLabel(QImage* image, PangoLayout* layout, int la
     gtk_style_context_add_class(styleContext, GTK_STYLE_CLASS_MENUBAR);
     gtk_style_context_add_class(styleContext, GTK_STYLE_CLASS_MENUITEM);
 
-    if (m_activatedByThisEntry) {
+    if (state == PrelightRenderState) {
         gtk_style_context_set_state(styleContext, GTK_STATE_FLAG_PRELIGHT);
     }
 
@@ -288,30 +361,41 @@ QPixmap IndicatorEntryWidget::decodeIcon()
     QPixmap pix;
 
     int type = m_entry->image_type();
+    const std::string& data = m_entry->image_data();
+
+    if (type == GTK_IMAGE_PIXBUF || type == GTK_IMAGE_GICON) {
+        pix = IconDecodeCache::instance()->pixmap(type, data);
+        if (!pix.isNull()) {
+            return pix;
+        }
+    }
 
     if (type == 0) {
         // No icon
     } else if (type == GTK_IMAGE_PIXBUF) {
-        QByteArray data = QByteArray::fromBase64(m_entry->image_data().c_str());
+        QByteArray decoded = QByteArray::fromBase64(data.c_str());
         QImage image;
-        bool ok = image.loadFromData(data);
+        bool ok = image.loadFromData(decoded);
         if (ok) {
             pix = QPixmap::fromImage(image);
+            IconDecodeCache::instance()->insert(type, data, pix);
         } else {
             UQ_WARNING << "Failed to decode image";
         }
     } else if (type == GTK_IMAGE_ICON_NAME) {
-        QString name = QString::fromStdString(m_entry->image_data());
+        // QIcon already caches theme lookups
+        QString name = QString::fromStdString(data);
         QIcon icon = QIcon::fromTheme(name);
         pix = icon.pixmap(ICON_SIZE, ICON_SIZE);
     } else if (type == GTK_IMAGE_GICON) {
-        QString name = QString::fromStdString(m_entry->image_data());
+        QString name = QString::fromStdString(data);
         QImage image = GImageUtils::imageForIconString(name, ICON_SIZE);
         if (image.isNull()) {
             UQ_WARNING << "Failed to load icon from" << name;
             return QPixmap();
         }
-        return QPixmap::fromImage(image);
+        pix = QPixmap::fromImage(image);
+        IconDecodeCache::instance()->insert(type, data, pix);
     } else {
         UQ_WARNING << "Unknown image type" << m_entry->image_type();
     }
@@ -22,6 +22,7 @@
 #define INDICATORENTRYWIDGET_H
 
 // Local
+#include <gconnector.h>
 
 // libunity-core
 #include <UnityCore/IndicatorEntry.h>
@@ -76,21 +77,41 @@ protected:
     void wheelEvent(QWheelEvent*);
     bool event(QEvent*);
 
+private Q_SLOTS:
+    void updatePix();
+
 private:
+    enum RenderState {
+        NormalRenderState,
+        PrelightRenderState,
+        RenderStateCount
+    };
+
     unity::indicator::Entry::Ptr m_entry;
     QPixmap m_pix;
+    // Rendered variants, reset when the content or the theme changes
+    QPixmap m_statePix[RenderStateCount];
+    QByteArray m_contentKey;
+    QPixmap m_iconPix;
+    int m_pixWidth;
+    int m_labelX;
     int m_padding;
     bool m_hasIcon;
     bool m_hasLabel;
     bool m_activatedByThisEntry;
     struct _GtkWidgetPath* m_gtkWidgetPath;
-    void updatePix();
+    GConnector m_gConnector;
+    static void onThemeChanged(GObject*, GParamSpec*, IndicatorEntryWidget*);
+    void onEntryUpdated();
     void onActiveChanged(bool active);
+    QByteArray contentKey() const;
+    void updateStatePix();
+    QPixmap renderStatePix(RenderState state);
     QPixmap decodeIcon();
     void paintActiveBackground(QImage*);
 
     struct _PangoLayout* createPangoLayout();
-    void paintLabel(QImage*, struct _PangoLayout*, int labelX);
+    void paintLabel(QImage*, struct _PangoLayout*, int labelX, RenderState state);
 };
 
 #endif /* INDICATORENTRYWIDGET_H */
@@ -24,23 +24,61 @@
 // Local
 #include <debug_p.h>
 #include <indicatorentrywidget.h>
+#include <pointermonitor.h>
 
 // Qt
 #include <QApplication>
+#include <QElapsedTimer>
 #include <QTimer>
 #include <QX11Info>
 
 // X11
 #include <X11/Xlib.h>
 
+// std
+#include <memory>
+
 using namespace unity::indicator;
 
+// Only measures how long handling a pointer position takes, not the delay
+// between the input and its handling
+static bool scrubHandlerTimeDebug()
+{
+    static bool enabled = !qgetenv("UNITY2D_DEBUG_SCRUB_HANDLER_TIME").isEmpty();
+    return enabled;
+}
+
+static bool s_sharedIndicators = false;
+
+static DBusIndicators::Ptr createIndicators()
+{
+    if (!s_sharedIndicators) {
+        return DBusIndicators::Ptr(new DBusIndicators);
+    }
+
+    // Keep the shared instance alive only as long as a manager uses it
+    static std::weak_ptr<DBusIndicators> sharedInstance;
+    DBusIndicators::Ptr indicators = sharedInstance.lock();
+    if (!indicators) {
+        indicators.reset(new DBusIndicators);
+        sharedInstance = indicators;
+    }
+    return indicators;
+}
+
+void IndicatorsManager::setSharedIndicators(bool shared)
+{
+    s_sharedIndicators = shared;
+}
+
 IndicatorsManager::IndicatorsManager(Unity2dPanel* panel, QObject* parent)
 : QObject(parent)
 , m_panel(panel)
-, m_indicators(new DBusIndicators)
+, m_indicators(createIndicators())
 , m_geometrySyncTimer(new QTimer(this))
 , m_mouseTrackerTimer(new QTimer(this))
+, m_pointerMonitor(PointerMonitor::instance())
+, m_locationsSynced(false)
 {
     m_geometrySyncTimer->setInterval(0);
     m_geometrySyncTimer->setSingleShot(true);
@@ -63,6 +101,7 @@ IndicatorsManager::IndicatorsManager(Unity2dPanel* panel, QObject* parent)
     m_mouseTrackerTimer->setInterval(16);
     m_mouseTrackerTimer->setSingleShot(false);
     connect(m_mouseTrackerTimer, SIGNAL(timeout()), SLOT(checkMousePosition()));
+    connect(m_pointerMonitor, SIGNAL(pointerMoved(QPoint)), SLOT(onPointerMoved(QPoint)));
 
     m_indicators->on_entry_show_menu.connect(
         sigc::mem_fun(this, &IndicatorsManager::onEntryShowMenu)
@@ -129,11 +168,22 @@ void IndicatorsManager::onEntryShowMenu(const std::string& /*entryId*/, unsigned
 
 void IndicatorsManager::checkMousePosition()
 {
-    // Called by m_mouseTrackerTimer to implement mouse scrubbing
+    // Called by m_mouseTrackerTimer when PointerMonitor is not available
+    processMousePosition(QCursor::pos());
+}
+
+void IndicatorsManager::onPointerMoved(const QPoint& pos)
+{
+    // Called by m_pointerMonitor, only while a menu is opened
+    processMousePosition(pos);
+}
+
+void IndicatorsManager::processMousePosition(const QPoint& pos)
+{
+    // Implements mouse scrubbing
     // (Assuming item A menu is opened, move mouse over item B => item B menu opens)
     // Also, delivers motion events to Qt, which will generate correct
     // enter/leave events for IndicatorEntry widgets.
-    QPoint pos = QCursor::pos();
 
     // Don't send the event unless the mouse has moved
     // https://bugs.launchpad.net/bugs/834065
@@ -142,6 +192,9 @@ void IndicatorsManager::checkMousePosition()
     }
     m_lastMousePosition = pos;
 
+    QElapsedTimer handlerTimer;
+    handlerTimer.start();
+
     QWidget* widget = QApplication::widgetAt(pos);
     Display* display = QX11Info::display();
 
@@ -168,6 +221,11 @@ void IndicatorsManager::checkMousePosition()
         return;
     }
     entryWidget->showMenu(Qt::NoButton);
+
+    if (scrubHandlerTimeDebug()) {
+        UQ_DEBUG << "Scrub handled in" << handlerTimer.nsecsElapsed() / 1000 << "us"
+                 << (m_mouseTrackerTimer->isActive() ? "(polling)" : "(XInput2)");
+    }
 }
 
 void IndicatorsManager::onEntryActivateRequest(const std::string& entryId)
@@ -193,15 +251,24 @@ void IndicatorsManager::onEntryActivateRequest(const std::string& entryId)
 
 void IndicatorsManager::onEntryActivated(const std::string& entryId, const nux::Rect& menu_geo)
 {
-    if (entryId.empty()) {
-        m_mouseTrackerTimer->stop();
-    } else {
+    bool tracking = !entryId.empty();
+    if (!tracking) {
+        m_lastMousePosition = QPoint();
+    }
+
+    if (m_pointerMonitor->isAvailable()) {
+        m_pointerMonitor->setTracking(tracking);
+    } else if (tracking) {
         m_mouseTrackerTimer->start();
+    } else {
+        m_mouseTrackerTimer->stop();
     }
 }
 
 void IndicatorsManager::onSynced()
 {
+    // The service may have been restarted, make sure it gets our locations
+    m_locationsSynced = false;
     QMetaObject::invokeMethod(m_geometrySyncTimer, "start", Qt::QueuedConnection);
 }
 
@@ -248,6 +315,14 @@ void IndicatorsManager::syncGeometries()
         locations[widget->entry()->id()] = rect;
     }
 
+    // The indicators may be shared by several panels, each of them scheduling
+    // a sync on every change: only send the locations which actually changed
+    if (m_locationsSynced && locations == m_lastLocations) {
+        return;
+    }
+    m_lastLocations = locations;
+    m_locationsSynced = true;
+
     m_indicators->SyncGeometries(m_panel->id().toUtf8().constData(), locations);
 }
 
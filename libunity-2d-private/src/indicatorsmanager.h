@@ -35,6 +35,7 @@
 class QTimer;
 
 class IndicatorEntryWidget;
+class PointerMonitor;
 
 /**
  * Instantiates DBusIndicators and implement common behavior
@@ -48,6 +49,13 @@ public:
 
     unity::indicator::DBusIndicators::Ptr indicators() const;
 
+    /**
+     * When enabled, managers created afterwards share the same
+     * DBusIndicators instance, so that the indicators state is received and
+     * updated only once for all panels.
+     */
+    static void setSharedIndicators(bool shared);
+
     void addIndicatorEntryWidget(IndicatorEntryWidget* widget);
     bool removeIndicatorEntryWidget(IndicatorEntryWidget* widget);
 
@@ -60,6 +68,7 @@ protected:
 private Q_SLOTS:
     void syncGeometries();
     void checkMousePosition();
+    void onPointerMoved(const QPoint& pos);
 
 private:
     Q_DISABLE_COPY(IndicatorsManager)
@@ -67,7 +76,10 @@ private:
     unity::indicator::DBusIndicators::Ptr m_indicators;
     QTimer* m_geometrySyncTimer;
     QTimer* m_mouseTrackerTimer;
+    PointerMonitor* m_pointerMonitor;
     QPoint m_lastMousePosition;
+    unity::indicator::EntryLocationMap m_lastLocations;
+    bool m_locationsSynced;
 
     IndicatorEntryWidgetList m_widgetList;
 
@@ -75,6 +87,7 @@ private:
     void onEntryShowMenu(const std::string&, unsigned int, int, int, unsigned int, unsigned int);
     void onEntryActivateRequest(const std::string& entryId);
     void onEntryActivated(const std::string& entryId, const nux::Rect& menu_geo);
+    void processMousePosition(const QPoint& pos);
 };
 
 #endif /* INDICATORSMANAGER_H */
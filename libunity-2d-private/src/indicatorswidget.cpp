@@ -63,6 +63,10 @@ void IndicatorsWidget::addIndicator(const unity::indicator::Indicator::Ptr& indi
                                   sigc::mem_fun(this, &IndicatorsWidget::onEntryRemoved)
                               );
     m_indicators_connections[indicator].append(conn);
+
+    Q_FOREACH(const Entry::Ptr& entry, indicator->GetEntries()) {
+        onEntryAdded(entry);
+    }
 }
 
 void IndicatorsWidget::removeIndicator(const unity::indicator::Indicator::Ptr& indicator)
@@ -0,0 +1,149 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "labellayoutcache.h"
+
+// libunity-2d
+#include <debug_p.h>
+#include <gconnector.h>
+#include <gscopedpointer.h>
+
+// Qt
+#include <QCache>
+#include <QPair>
+
+// GTK
+#include <gtk/gtk.h>
+
+// Clock, network and friends each cycle through a handful of labels, this
+// is enough to keep all of them around
+static const int MAX_LAYOUTS = 64;
+
+struct LayoutEntry
+{
+    LayoutEntry(PangoLayout* layout_) : layout(layout_) {}
+    ~LayoutEntry() { g_object_unref(layout); }
+    PangoLayout* layout;
+};
+
+typedef QPair<QString, bool> LayoutKey;
+
+class LabelLayoutCachePrivate
+{
+public:
+    LabelLayoutCache* q;
+    GConnector m_gConnector;
+    GObjectScopedPointer<PangoContext> m_pangoContext;
+    GScopedPointer<PangoFontDescription, pango_font_description_free> m_fontDescription;
+    QCache<LayoutKey, LayoutEntry> m_layouts;
+
+    static void onFontChanged(GObject*, GParamSpec*, gpointer data)
+    {
+        LabelLayoutCachePrivate* priv = reinterpret_cast<LabelLayoutCachePrivate*>(data);
+        priv->m_layouts.clear();
+        priv->m_pangoContext.reset();
+        priv->m_fontDescription.reset();
+        Q_EMIT priv->q->fontChanged();
+    }
+
+    void ensureContext()
+    {
+        if (!m_pangoContext.isNull()) {
+            return;
+        }
+        m_pangoContext.reset(gdk_pango_context_get());
+
+        char* fontName = NULL;
+        g_object_get(gtk_settings_get_default(), "gtk-font-name", &fontName, NULL);
+        m_fontDescription.reset(pango_font_description_from_string(fontName));
+        pango_font_description_set_weight(m_fontDescription.data(), PANGO_WEIGHT_NORMAL);
+        g_free(fontName);
+    }
+
+    PangoLayout* createLayout(const QString& label, bool showMnemonics)
+    {
+        ensureContext();
+
+        // Parse
+        PangoAttrList* attrs = NULL;
+        if (showMnemonics) {
+            if (!pango_parse_markup(label.toUtf8().constData(),
+                                    -1,
+                                    '_',
+                                    &attrs,
+                                    NULL,
+                                    NULL,
+                                    NULL))
+            {
+                UQ_WARNING << "pango_parse_markup failed";
+            }
+        }
+
+        // Create layout
+        PangoLayout* layout = pango_layout_new(m_pangoContext.data());
+
+        if (attrs) {
+            pango_layout_set_attributes(layout, attrs);
+            pango_attr_list_unref(attrs);
+        }
+
+        pango_layout_set_font_description(layout, m_fontDescription.data());
+
+        // Set text
+        QString text = label;
+        text.replace('_', QString());
+        QByteArray utf8Text = text.toUtf8();
+        pango_layout_set_text(layout, utf8Text.data(), -1);
+
+        return layout;
+    }
+};
+
+LabelLayoutCache::LabelLayoutCache()
+: d(new LabelLayoutCachePrivate)
+{
+    d->q = this;
+    d->m_layouts.setMaxCost(MAX_LAYOUTS);
+
+    d->m_gConnector.connect(gtk_settings_get_default(), "notify::gtk-font-name",
+        G_CALLBACK(LabelLayoutCachePrivate::onFontChanged), d);
+}
+
+LabelLayoutCache::~LabelLayoutCache()
+{
+    delete d;
+}
+
+LabelLayoutCache* LabelLayoutCache::instance()
+{
+    static LabelLayoutCache cache;
+    return &cache;
+}
+
+PangoLayout* LabelLayoutCache::layout(const QString& label, bool showMnemonics)
+{
+    const LayoutKey key(label, showMnemonics);
+    LayoutEntry* entry = d->m_layouts.object(key);
+    if (!entry) {
+        entry = new LayoutEntry(d->createLayout(label, showMnemonics));
+        d->m_layouts.insert(key, entry);
+    }
+    return PANGO_LAYOUT(g_object_ref(entry->layout));
+}
+
+#include "labellayoutcache.moc"
@@ -0,0 +1,69 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LABELLAYOUTCACHE_H
+#define LABELLAYOUTCACHE_H
+
+// Qt
+#include <QObject>
+
+struct _PangoLayout;
+
+class LabelLayoutCachePrivate;
+/**
+ * Shares the Pango context, font description and label layouts used to
+ * render panel labels.
+ *
+ * Layouts are kept in a LRU keyed by the label text and whether it contains
+ * mnemonics, so that an indicator resending the same label, or the same
+ * label shown on several panels, is only parsed and laid out once.
+ * Everything is dropped when the gtk-font-name setting changes.
+ */
+class LabelLayoutCache : public QObject
+{
+    Q_OBJECT
+public:
+    ~LabelLayoutCache();
+
+    static LabelLayoutCache* instance();
+
+    /**
+     * Returns a layout for @p label. If @p showMnemonics is true, the
+     * character following an underscore is underlined, otherwise underscores
+     * are just removed.
+     *
+     * The returned layout is shared: the caller gets a new reference and
+     * must not modify its text or attributes.
+     */
+    struct _PangoLayout* layout(const QString& label, bool showMnemonics);
+
+Q_SIGNALS:
+    /**
+     * Emitted when the font changed. Layouts returned before must not be used
+     * anymore.
+     */
+    void fontChanged();
+
+private:
+    LabelLayoutCache();
+    Q_DISABLE_COPY(LabelLayoutCache)
+    friend class LabelLayoutCachePrivate;
+    // Use a pimpl to avoid the need for gtk includes here
+    LabelLayoutCachePrivate* const d;
+};
+
+#endif /* LABELLAYOUTCACHE_H */
@@ -0,0 +1,145 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "launcherstatesnapshot.h"
+
+// libunity-2d
+#include <debug_p.h>
+
+// Qt
+#include <QDataStream>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+// libc
+#include <stdio.h>
+#include <stdlib.h>
+
+static const quint32 SNAPSHOT_MAGIC = 0x55324c53; // "U2LS"
+// Bump whenever the layout of the file changes
+static const quint32 SNAPSHOT_VERSION = 1;
+
+static QDataStream& operator<<(QDataStream& stream, const LauncherStateSnapshot::Entry& entry)
+{
+    return stream << entry.desktopFile << entry.name << entry.icon << entry.executable;
+}
+
+static QDataStream& operator>>(QDataStream& stream, LauncherStateSnapshot::Entry& entry)
+{
+    return stream >> entry.desktopFile >> entry.name >> entry.icon >> entry.executable;
+}
+
+LauncherStateSnapshot::LauncherStateSnapshot()
+{
+}
+
+QStringList LauncherStateSnapshot::favorites() const
+{
+    return m_favorites;
+}
+
+void LauncherStateSnapshot::setFavorites(const QStringList& favorites)
+{
+    m_favorites = favorites;
+}
+
+QList<LauncherStateSnapshot::Entry> LauncherStateSnapshot::entries() const
+{
+    return m_entries;
+}
+
+void LauncherStateSnapshot::setEntries(const QList<Entry>& entries)
+{
+    m_entries = entries;
+}
+
+QString LauncherStateSnapshot::fileName()
+{
+    QString cacheHome = QFile::decodeName(getenv("XDG_CACHE_HOME"));
+    if (cacheHome.isEmpty()) {
+        cacheHome = QDir::homePath() + "/.cache";
+    }
+    return cacheHome + "/unity-2d/launcher-state";
+}
+
+bool LauncherStateSnapshot::load()
+{
+    QFile file(fileName());
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+    /* Map the file rather than reading it, this happens on the startup path */
+    const qint64 size = file.size();
+    uchar* data = file.map(0, size);
+    if (data == NULL) {
+        return false;
+    }
+    const QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data), size);
+    QDataStream stream(bytes);
+    stream.setVersion(QDataStream::Qt_4_6);
+
+    quint32 magic, version;
+    stream >> magic >> version;
+    if (magic != SNAPSHOT_MAGIC || version != SNAPSHOT_VERSION) {
+        UQ_DEBUG << "Ignoring launcher state snapshot with version" << version;
+        return false;
+    }
+
+    QStringList favorites;
+    QList<Entry> entries;
+    stream >> favorites >> entries;
+    if (stream.status() != QDataStream::Ok) {
+        UQ_WARNING << "Launcher state snapshot is corrupted:" << file.fileName();
+        return false;
+    }
+    m_favorites = favorites;
+    m_entries = entries;
+    return true;
+}
+
+bool LauncherStateSnapshot::save() const
+{
+    const QString name = fileName();
+    QDir().mkpath(QFileInfo(name).path());
+
+    /* Write a temporary file and move it over the snapshot, so that a crash
+       never leaves a truncated snapshot behind */
+    const QString tmpName = name + ".tmp";
+    QFile file(tmpName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        UQ_WARNING << "Could not write launcher state snapshot:" << file.errorString();
+        return false;
+    }
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_4_6);
+    stream << SNAPSHOT_MAGIC << SNAPSHOT_VERSION << m_favorites << m_entries;
+    file.close();
+    if (file.error() != QFile::NoError) {
+        UQ_WARNING << "Could not write launcher state snapshot:" << file.errorString();
+        QFile::remove(tmpName);
+        return false;
+    }
+
+    if (rename(QFile::encodeName(tmpName).constData(), QFile::encodeName(name).constData()) != 0) {
+        UQ_WARNING << "Could not replace launcher state snapshot" << name;
+        QFile::remove(tmpName);
+        return false;
+    }
+    return true;
+}
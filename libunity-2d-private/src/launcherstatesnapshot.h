@@ -0,0 +1,72 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LAUNCHERSTATESNAPSHOT_H
+#define LAUNCHERSTATESNAPSHOT_H
+
+// Qt
+#include <QList>
+#include <QString>
+#include <QStringList>
+
+/**
+ * Last known state of the launcher favorites, saved in the user cache
+ * directory so that the launcher can show them at startup without parsing
+ * their desktop files or waiting for bamf.
+ *
+ * The snapshot is only valid for the favorites it was saved for: callers are
+ * expected to compare favorites() with the current setting before using
+ * entries().
+ */
+class LauncherStateSnapshot
+{
+public:
+    struct Entry
+    {
+        QString desktopFile;
+        QString name;
+        QString icon;
+        QString executable;
+    };
+
+    LauncherStateSnapshot();
+
+    QStringList favorites() const;
+    void setFavorites(const QStringList& favorites);
+
+    QList<Entry> entries() const;
+    void setEntries(const QList<Entry>& entries);
+
+    /**
+     * Reads the snapshot file. Returns false if there is none, or if it was
+     * written by an incompatible version.
+     */
+    bool load();
+
+    /**
+     * Atomically replaces the snapshot file
+     */
+    bool save() const;
+
+    static QString fileName();
+
+private:
+    QStringList m_favorites;
+    QList<Entry> m_entries;
+};
+
+#endif /* LAUNCHERSTATESNAPSHOT_H */
@@ -0,0 +1,77 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "metricsdbus.h"
+
+// Local
+#include "unity2dmetrics.h"
+#include "wakeupmonitor.h"
+
+// libunity-2d
+#include <debug_p.h>
+
+// Qt
+#include <QDBusConnection>
+
+static const char* METRICS_DBUS_OBJECT_PATH = "/Metrics";
+
+MetricsDBus::MetricsDBus(QObject* parent)
+: QObject(parent)
+{
+}
+
+bool MetricsDBus::connectToBus()
+{
+    bool ok = QDBusConnection::sessionBus().registerObject(METRICS_DBUS_OBJECT_PATH, this,
+                                                           QDBusConnection::ExportAllSlots);
+    if (!ok) {
+        UQ_WARNING << "The object" << METRICS_DBUS_OBJECT_PATH << "is already present on DBUS.";
+    }
+    return ok;
+}
+
+QVariantMap MetricsDBus::Counters()
+{
+    return Unity2dMetrics::instance()->counters();
+}
+
+QVariantMap MetricsDBus::Gauges()
+{
+    return Unity2dMetrics::instance()->gauges();
+}
+
+QVariantMap MetricsDBus::Histograms()
+{
+    return Unity2dMetrics::instance()->histograms();
+}
+
+QVariantList MetricsDBus::BucketBounds()
+{
+    QVariantList bounds;
+    Q_FOREACH(qint64 bound, Unity2dMetrics::bucketBounds()) {
+        bounds << bound;
+    }
+    return bounds;
+}
+
+double MetricsDBus::WakeupsPerSecond()
+{
+    return WakeupMonitor::instance()->wakeupsPerSecond();
+}
+
+#include "metricsdbus.moc"
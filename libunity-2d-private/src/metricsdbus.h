@@ -0,0 +1,63 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef METRICSDBUS_H
+#define METRICSDBUS_H
+
+// Qt
+#include <QObject>
+#include <QVariant>
+
+/**
+ * D-Bus interface to the Unity2dMetrics registry, exported as /Metrics next
+ * to the other objects of the process. The panel owns no well-known name, its
+ * /Metrics object is reached through its unique connection name. It is
+ * read-only: the frame profiler is switched through FrameProfilerDBus.
+ *
+ * Histograms are maps with "count", "sum" and "max" (in microseconds for
+ * durations), "bounds", the upper bounds of the buckets, and "buckets", the
+ * number of samples per bucket. The last bucket has no upper bound.
+ * BucketBounds() returns the bounds used by the duration histograms.
+ * WakeupsPerSecond() is the only figure computed on request.
+ */
+class MetricsDBus : public QObject
+{
+    Q_OBJECT
+    Q_CLASSINFO("D-Bus Interface", "com.canonical.Unity2d.Metrics")
+
+public:
+    MetricsDBus(QObject* parent = 0);
+
+    /**
+     * Registers the object on the session bus, under the names the process
+     * already owns
+     */
+    bool connectToBus();
+
+public Q_SLOTS:
+    QVariantMap Counters();
+    QVariantMap Gauges();
+    QVariantMap Histograms();
+    QVariantList BucketBounds();
+
+    /**
+     * Recent wakeups of the event loop per second, see WakeupMonitor
+     */
+    double WakeupsPerSecond();
+};
+
+#endif /* METRICSDBUS_H */
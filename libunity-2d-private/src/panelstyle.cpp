@@ -25,6 +25,7 @@
 #include <debug_p.h>
 #include <gconnector.h>
 #include <gscopedpointer.h>
+#include <unity2dmetrics.h>
 
 // Qt
 #include <QApplication>
@@ -36,6 +37,9 @@
 
 static const char* METACITY_THEME_DIR = "/usr/share/themes/%1/metacity-1";
 
+static const int WINDOW_BUTTON_TYPE_COUNT = PanelStyle::MaximizeWindowButton + 1;
+static const int WINDOW_BUTTON_STATE_COUNT = PanelStyle::PressedState + 1;
+
 class PanelStylePrivate
 {
 public:
@@ -44,6 +48,7 @@ public:
     GConnector m_gConnector;
 
     QString m_themeName;
+    QPixmap m_windowButtonPixmaps[WINDOW_BUTTON_TYPE_COUNT][WINDOW_BUTTON_STATE_COUNT];
 
     static void onThemeChanged(GObject*, GParamSpec*, gpointer data)
     {
@@ -57,6 +62,26 @@ public:
         g_object_get(gtk_settings_get_default(), "gtk-theme-name", &themeName, NULL);
         m_themeName = QString::fromUtf8(themeName);
         g_free(themeName);
+
+        loadWindowButtonPixmaps();
+    }
+
+    void loadWindowButtonPixmaps()
+    {
+        // According to Unity PanelStyle code, the buttons of some WM themes do not
+        // match well with the panel background. So except for themes we provide,
+        // fallback to generic button pixmaps.
+        bool useWMTheme = m_themeName == "Ambiance" || m_themeName == "Radiance";
+
+        for (int type = 0; type < WINDOW_BUTTON_TYPE_COUNT; ++type) {
+            for (int state = 0; state < WINDOW_BUTTON_STATE_COUNT; ++state) {
+                PanelStyle::WindowButtonType buttonType = PanelStyle::WindowButtonType(type);
+                PanelStyle::WindowButtonState buttonState = PanelStyle::WindowButtonState(state);
+                m_windowButtonPixmaps[type][state] = useWMTheme
+                    ? windowButtonPixmapFromWMTheme(buttonType, buttonState)
+                    : genericWindowButtonPixmap(buttonType, buttonState);
+            }
+        }
     }
 
     QPixmap windowButtonPixmapFromWMTheme(PanelStyle::WindowButtonType type, PanelStyle::WindowButtonState state)
@@ -95,12 +120,13 @@ public:
             .arg(dir)
             .arg(typeString)
             .arg(stateString);
+        UQ_METRIC_COUNT("panelstyle.button_pixmaps_loaded");
         return QPixmap(path);
     }
 
     QPixmap genericWindowButtonPixmap(PanelStyle::WindowButtonType type, PanelStyle::WindowButtonState state)
     {
-        QStyle::StandardPixmap standardIcon;
+        QStyle::StandardPixmap standardIcon = QStyle::SP_TitleBarCloseButton;
         switch (type) {
         case PanelStyle::CloseWindowButton:
             standardIcon = QStyle::SP_TitleBarCloseButton;
@@ -171,12 +197,5 @@ GtkStyleContext* PanelStyle::styleContext() const
 
 QPixmap PanelStyle::windowButtonPixmap(PanelStyle::WindowButtonType type, PanelStyle::WindowButtonState state)
 {
-    // According to Unity PanelStyle code, the buttons of some WM themes do not
-    // match well with the panel background. So except for themes we provide,
-    // fallback to generic button pixmaps.
-    if (d->m_themeName == "Ambiance" || d->m_themeName == "Radiance") {
-        return d->windowButtonPixmapFromWMTheme(type, state);
-    } else {
-        return d->genericWindowButtonPixmap(type, state);
-    }
+    return d->m_windowButtonPixmaps[type][state];
 }
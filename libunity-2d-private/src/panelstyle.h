@@ -57,6 +57,11 @@ public:
 
     struct _GtkStyleContext* styleContext() const;
 
+    /**
+     * Returns the pixmap for a window button. All pixmaps are loaded at once
+     * when the theme changes, so this never hits the disk: the
+     * "panelstyle.button_pixmaps_loaded" metric only grows on theme changes.
+     */
     QPixmap windowButtonPixmap(WindowButtonType, WindowButtonState);
 
 private:
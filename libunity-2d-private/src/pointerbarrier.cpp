@@ -16,7 +16,6 @@
 
 // Qt
 #include <QDebug>
-#include <QTimer>
 #include <QX11Info>
 
 // libunity-2d
@@ -27,6 +26,9 @@
 // Self
 #include "pointerbarrier.h"
 
+/* Velocities are averaged over this period of time, in milliseconds */
+static const int SMOOTHING_PERIOD = 75;
+
 PointerBarrierWrapper::PointerBarrierWrapper(QObject *parent)
     : QObject(parent)
     , m_barrier(0)
@@ -38,17 +40,12 @@ PointerBarrierWrapper::PointerBarrierWrapper(QObject *parent)
     , m_decayRate(-1)
     , m_triggerPressure(-1)
     , m_breakPressure(-1)
-    , m_smoothingTimer(new QTimer(this))
     , m_lastEventX(0)
     , m_lastEventY(0)
     , m_lastEventId(0)
-    , m_smoothingCount(0)
-    , m_smoothingAccumulator(0)
+    , m_lastEventTimestamp(0)
+    , m_hasLastEvent(false)
 {
-    m_smoothingTimer->setSingleShot(true);
-    m_smoothingTimer->setInterval(75);
-    connect(m_smoothingTimer, SIGNAL(timeout()), this, SLOT(smoother()));
-
     PointerBarrierManager::instance()->addBarrier(this);
 }
 
@@ -201,24 +198,62 @@ void PointerBarrierWrapper::destroyBarrier()
     }
 }
 
-void PointerBarrierWrapper::doProcess(XFixesBarrierNotifyEvent *notifyEvent)
+void PointerBarrierWrapper::doProcess(const PointerBarrierEvent &event)
 {
-    m_lastEventX = notifyEvent->x;
-    m_lastEventY = notifyEvent->y;
-    m_lastEventId = notifyEvent->event_id;
-    m_smoothingAccumulator += notifyEvent->velocity;
-    m_smoothingCount++;
+    /* Computed before updating m_lastEventTimestamp */
+    const qreal velocity = smoothedVelocity(event);
 
-    /* Gathers events for m_smoothingTimer->interval() miliseconds, then takes average */
-    if (!m_smoothingTimer->isActive()) {
-        m_smoothingTimer->start();
-    }
+    m_lastEventX = event.x;
+    m_lastEventY = event.y;
+    m_lastEventId = event.eventId;
+    m_lastEventTimestamp = event.timestamp;
+    m_hasLastEvent = true;
 
-    if (m_triggerOnly && !isLastEventAgainstTrigger()) {
+    const bool againstTrigger = isLastEventAgainstTrigger();
+    if (m_triggerOnly && !againstTrigger) {
         // We got to the barrier from the non triggering direction
         // Release it so the mouse can continue its travel
+        releasePointer();
+    }
+
+    if (m_maxVelocityMultiplier < 0 || m_decayRate < 0 || m_breakPressure < 0) {
+        qWarning() << "PointerBarrierWrapper::doProcess: maxVelocityMultiplier, decayRate or breakPressure not set";
+        return;
+    }
+
+    /* Pressure is updated right away, no need to wait for more events */
+    if (againstTrigger) {
+        if (m_triggerValue.addAndCheckExceedingTarget(velocity, event.timestamp)) {
+            Q_EMIT triggered();
+        }
+    } else {
+        if (m_breakValue.addAndCheckExceedingTarget(velocity, event.timestamp)) {
+            releasePointer();
+            Q_EMIT broken();
+        }
+    }
+}
+
+qreal PointerBarrierWrapper::smoothedVelocity(const PointerBarrierEvent &event) const
+{
+    const qreal velocity = qMin<qreal>(600 * m_maxVelocityMultiplier, event.velocity);
+
+    /* Each event contributes to the pressure in proportion to the time it
+       stands for, so that pushing for SMOOTHING_PERIOD milliseconds adds the
+       average velocity over that period, whatever the event rate. An event
+       following a pause stands for a whole period. */
+    quint32 elapsed = SMOOTHING_PERIOD;
+    if (m_hasLastEvent) {
+        elapsed = qMin<quint32>(event.timestamp - m_lastEventTimestamp, SMOOTHING_PERIOD);
+    }
+    return velocity * elapsed / SMOOTHING_PERIOD;
+}
+
+void PointerBarrierWrapper::releasePointer()
+{
+    if (m_barrier != 0) {
         Display *display = QX11Info::display();
-        XFixesBarrierReleasePointer (display, m_barrier, m_lastEventId);
+        XFixesBarrierReleasePointer(display, m_barrier, m_lastEventId);
     }
 }
 
@@ -302,35 +337,6 @@ PointerBarrier PointerBarrierWrapper::barrier() const
     return m_barrier;
 }
 
-void PointerBarrierWrapper::smoother()
-{
-    if (m_maxVelocityMultiplier < 0 || m_decayRate < 0 || m_breakPressure < 0) {
-        qWarning() << "PointerBarrierWrapper::smoother: maxVelocityMultiplier, decayRate or breakPressure not set";
-        return;
-    }
-
-    if (m_smoothingCount <= 0) {
-        return;
-    }
-    const int velocity = qMin<qreal>(600 * m_maxVelocityMultiplier, m_smoothingAccumulator / m_smoothingCount);
-
-    if (isLastEventAgainstTrigger()) {
-        if (m_triggerValue.addAndCheckExceedingTarget(velocity)) {
-            Q_EMIT triggered();
-        }
-    } else {
-        if (m_breakValue.addAndCheckExceedingTarget(velocity)) {
-            Display *display = QX11Info::display();
-            XFixesBarrierReleasePointer (display, m_barrier, m_lastEventId);
-
-            Q_EMIT broken();
-        }
-    }
-
-    m_smoothingAccumulator = 0;
-    m_smoothingCount = 0;
-}
-
 void PointerBarrierWrapper::updateRealDecayTargetPressures()
 {
     // make the effect half as strong as specified as other values shouldn't scale
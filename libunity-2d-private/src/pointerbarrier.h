@@ -27,6 +27,19 @@
 
 struct PointerBarrierWrapperPrivate;
 
+/**
+ * A barrier hit, as decoded from XFixesBarrierNotifyEvent by
+ * PointerBarrierManager
+ */
+struct PointerBarrierEvent
+{
+    int x;
+    int y;
+    int velocity;
+    int eventId;
+    quint32 timestamp;
+};
+
 class PointerBarrierWrapper : public QObject
 {
     Q_OBJECT
@@ -113,16 +126,15 @@ Q_SIGNALS:
     void triggered();
     void broken();
 
-private Q_SLOTS:
-    void smoother();
-
 private:
     Q_DISABLE_COPY(PointerBarrierWrapper);
 
     void createBarrier();
     void destroyBarrier();
 
-    void doProcess(XFixesBarrierNotifyEvent *event);
+    void doProcess(const PointerBarrierEvent &event);
+    qreal smoothedVelocity(const PointerBarrierEvent &event) const;
+    void releasePointer();
 
     void updateRealDecayTargetPressures();
 
@@ -147,13 +159,11 @@ private:
     int m_triggerPressure;
     int m_breakPressure;
 
-    QTimer *m_smoothingTimer;
-
     int m_lastEventX;
     int m_lastEventY;
     int m_lastEventId;
-    int m_smoothingCount;
-    int m_smoothingAccumulator;
+    quint32 m_lastEventTimestamp;
+    bool m_hasLastEvent;
 
     DecayedValue m_triggerValue;
     DecayedValue m_breakValue;
@@ -65,18 +65,30 @@ void PointerBarrierManager::removeBarrier(PointerBarrierWrapper *barrier)
     m_barriers -= barrier;
 }
 
+bool PointerBarrierManager::dispatchEvent(PointerBarrier barrierId, const PointerBarrierEvent &event)
+{
+    Q_FOREACH (PointerBarrierWrapper *barrier, m_barriers) {
+        if (barrier->barrier() == barrierId) {
+            barrier->doProcess(event);
+            return true;
+        }
+    }
+    return false;
+}
+
 bool PointerBarrierManager::x11EventFilter(XEvent* event)
 {
     if (event->type - m_eventBase == XFixesBarrierNotify) {
         XFixesBarrierNotifyEvent *notifyEvent = (XFixesBarrierNotifyEvent *)event;
 
         if (notifyEvent->subtype == XFixesBarrierHitNotify) {
-            Q_FOREACH (PointerBarrierWrapper *barrier, m_barriers) {
-                if (barrier->barrier() == notifyEvent->barrier) {
-                    barrier->doProcess(notifyEvent);
-                    return true;
-                }
-            }
+            PointerBarrierEvent barrierEvent;
+            barrierEvent.x = notifyEvent->x;
+            barrierEvent.y = notifyEvent->y;
+            barrierEvent.velocity = notifyEvent->velocity;
+            barrierEvent.eventId = notifyEvent->event_id;
+            barrierEvent.timestamp = notifyEvent->timestamp;
+            return dispatchEvent(notifyEvent->barrier, barrierEvent);
         }
     }
     return false;
@@ -19,8 +19,16 @@
 
 #include "unity2dapplication.h"
 
+// X11
+#include <X11/extensions/Xfixes.h>
+
 class PointerBarrierWrapper;
+struct PointerBarrierEvent;
 
+/**
+ * Single reader of XFixes barrier events, dispatching them to the
+ * PointerBarrierWrapper owning the barrier which was hit.
+ */
 class PointerBarrierManager : protected AbstractX11EventFilter
 {
 public:
@@ -29,6 +37,15 @@ public:
     void addBarrier(PointerBarrierWrapper *barrier);
     void removeBarrier(PointerBarrierWrapper *barrier);
 
+    /**
+     * Delivers @p event to the wrapper of @p barrier. Returns false if no
+     * wrapper owns that barrier.
+     *
+     * This is what x11EventFilter() calls for each barrier hit, it is public
+     * so that recorded events can be replayed.
+     */
+    bool dispatchEvent(PointerBarrier barrier, const PointerBarrierEvent &event);
+
 protected:
     bool x11EventFilter(XEvent* event);
 
@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2012 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Self
+#include "pointermonitor.h"
+
+// Qt
+#include <QSocketNotifier>
+#include <QDebug>
+
+// libunity-2d
+#include <unity2dmetrics.h>
+
+// X11
+#include <X11/Xlib.h>
+#include <X11/extensions/XInput2.h>
+
+// Local
+#include <debug_p.h>
+
+PointerMonitor::PointerMonitor(QObject* parent)
+: QObject(parent)
+, m_display(0)
+, m_xiOpcode(0)
+, m_available(false)
+, m_tracking(false)
+{
+    m_available = registerEvents();
+}
+
+PointerMonitor::~PointerMonitor()
+{
+    if (m_display != 0) {
+        XCloseDisplay(m_display);
+    }
+}
+
+PointerMonitor* PointerMonitor::instance()
+{
+    static PointerMonitor* monitor = new PointerMonitor();
+    return monitor;
+}
+
+bool PointerMonitor::isAvailable() const
+{
+    return m_available;
+}
+
+bool PointerMonitor::isTracking() const
+{
+    return m_tracking;
+}
+
+void PointerMonitor::setTracking(bool tracking)
+{
+    if (!m_available || m_tracking == tracking) {
+        return;
+    }
+    m_tracking = tracking;
+    selectEvents(tracking);
+}
+
+bool PointerMonitor::registerEvents()
+{
+    /* Use a private connection so that we can drain our events without
+       interfering with Qt's own event processing */
+    m_display = XOpenDisplay(NULL);
+    if (m_display == 0) {
+        UQ_WARNING << "Could not open X display.";
+        return false;
+    }
+
+    int event, error;
+    if (!XQueryExtension(m_display, "XInputExtension", &m_xiOpcode, &event, &error)) {
+        UQ_DEBUG << "XInput extension not available, pointer will be polled.";
+        return false;
+    }
+
+    /* Raw events are only delivered during a grab since XInput 2.1 */
+    int major = 2;
+    int minor = 1;
+    if (XIQueryVersion(m_display, &major, &minor) != Success
+        || major < 2 || (major == 2 && minor < 1)) {
+        UQ_DEBUG << "XInput 2.1 not available, pointer will be polled.";
+        return false;
+    }
+
+    /* Dispatch XEvents when there is activity on the X11 file descriptor */
+    int x11FileDescriptor = ConnectionNumber(m_display);
+    QSocketNotifier* socketNotifier = new QSocketNotifier(x11FileDescriptor, QSocketNotifier::Read, this);
+    connect(socketNotifier, SIGNAL(activated(int)), this, SLOT(x11EventDispatch()));
+
+    return true;
+}
+
+void PointerMonitor::selectEvents(bool enabled)
+{
+    unsigned char mask[XIMaskLen(XI_LASTEVENT)] = { 0 };
+    if (enabled) {
+        XISetMask(mask, XI_RawMotion);
+    }
+
+    XIEventMask eventMask;
+    eventMask.deviceid = XIAllMasterDevices;
+    eventMask.mask_len = sizeof(mask);
+    eventMask.mask = mask;
+
+    XISelectEvents(m_display, DefaultRootWindow(m_display), &eventMask, 1);
+    XFlush(m_display);
+}
+
+void PointerMonitor::x11EventDispatch()
+{
+    XEvent event;
+    bool moved = false;
+
+    /* Coalesce all the pending motion into a single notification */
+    while (XPending(m_display) > 0) {
+        XNextEvent(m_display, &event);
+        XGenericEventCookie* cookie = &event.xcookie;
+        if (cookie->type != GenericEvent || cookie->extension != m_xiOpcode) {
+            continue;
+        }
+        if (XGetEventData(m_display, cookie)) {
+            if (cookie->evtype == XI_RawMotion) {
+                moved = true;
+            }
+            XFreeEventData(m_display, cookie);
+        }
+    }
+
+    if (!moved || !m_tracking) {
+        return;
+    }
+
+    /* Raw events carry device deltas only, ask for the actual position */
+    Window root, child;
+    int rootX, rootY, winX, winY;
+    unsigned int mask;
+    UQ_METRIC_COUNT("x11.roundtrips");
+    if (XQueryPointer(m_display, DefaultRootWindow(m_display), &root, &child,
+                      &rootX, &rootY, &winX, &winY, &mask)) {
+        Q_EMIT pointerMoved(QPoint(rootX, rootY));
+    }
+}
+
+#include "pointermonitor.moc"
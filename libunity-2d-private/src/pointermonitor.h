@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2012 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef POINTERMONITOR_H
+#define POINTERMONITOR_H
+
+// Qt
+#include <QObject>
+#include <QPoint>
+
+typedef struct _XDisplay Display;
+
+/**
+ * This class monitors global pointer motion using XInput2 raw events.
+ *
+ * Raw events are delivered to the root window even while another client holds
+ * the pointer grab (which is the case while a panel menu is opened), so
+ * unlike polling QCursor::pos() this only wakes up when the pointer actually
+ * moves. Motion is only reported while tracking is enabled.
+ *
+ * If the X server does not support XInput 2.1 isAvailable() returns false and
+ * users are expected to fall back to polling.
+ */
+class PointerMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    static PointerMonitor* instance();
+    ~PointerMonitor();
+
+    bool isAvailable() const;
+
+    bool isTracking() const;
+    void setTracking(bool tracking);
+
+Q_SIGNALS:
+    /**
+     * Emitted once per batch of motion events with the current position of
+     * the pointer, in global coordinates.
+     */
+    void pointerMoved(const QPoint& pos);
+
+private:
+    PointerMonitor(QObject* parent=0);
+
+    bool registerEvents();
+    void selectEvents(bool enabled);
+
+private Q_SLOTS:
+    void x11EventDispatch();
+
+private:
+    Display *m_display;
+    int m_xiOpcode;
+    bool m_available;
+    bool m_tracking;
+};
+
+#endif // POINTERMONITOR_H
@@ -23,21 +23,25 @@
 // Self
 #include "strutmanager.h"
 
+// Local
+#include <debug_p.h>
+#include <unity2dmetrics.h>
+
 // Qt
 #include <QApplication>
 #include <QDesktopWidget>
+#include <QTimer>
 #include <QX11Info>
 
 // X
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
+#include "x11properties.h"
 
-static void setStrut(ulong* struts, WId effectiveWinId)
+static bool strutDebug()
 {
-    static Atom atom = XInternAtom(QX11Info::display(), "_NET_WM_STRUT_PARTIAL", False);
-    XChangeProperty(QX11Info::display(), effectiveWinId, atom,
-                    XA_CARDINAL, 32, PropModeReplace,
-                    (unsigned char *) struts, 12);
+    static bool enabled = !qgetenv("UNITY2D_DEBUG_STRUTS").isEmpty();
+    return enabled;
 }
 
 StrutManager::StrutManager()
@@ -45,8 +49,19 @@ StrutManager::StrutManager()
    m_widget(NULL),
    m_edge(Unity2dPanel::TopEdge),
    m_width(-1),
-   m_height(-1)
+   m_height(-1),
+   m_updateTimer(new QTimer(this)),
+   m_lastWinId(0)
 {
+    memset(m_lastStruts, 0, sizeof m_lastStruts);
+
+    /* Changing the strut makes the WM recompute the work area, which in turn
+       emits workAreaResized(): coalesce all the requests received during an
+       event loop iteration into a single update */
+    m_updateTimer->setInterval(0);
+    m_updateTimer->setSingleShot(true);
+    connect(m_updateTimer, SIGNAL(timeout()), SLOT(reserveStrut()));
+
     QDesktopWidget* desktop = QApplication::desktop();
     connect(desktop, SIGNAL(resized(int)), SLOT(updateStrut()));
     connect(desktop, SIGNAL(workAreaResized(int)), SLOT(updateStrut()));
@@ -164,12 +179,14 @@ int StrutManager::realHeight() const
 void StrutManager::updateStrut()
 {
     if (m_enabled) {
-        reserveStrut();
+        m_updateTimer->start();
     }
 }
 
 void StrutManager::reserveStrut()
 {
+    m_updateTimer->stop();
+
     if (m_widget == NULL)
         return;
 
@@ -177,7 +194,7 @@ void StrutManager::reserveStrut()
     const QRect screen = desktop->screenGeometry(m_widget);
     const QRect available = desktop->availableGeometry(m_widget);
 
-    ulong struts[12] = {};
+    ulong struts[STRUT_SIZE] = {};
     switch (m_edge) {
     case Unity2dPanel::LeftEdge:
         if (QApplication::isLeftToRight()) {
@@ -202,17 +219,41 @@ void StrutManager::reserveStrut()
         break;
     }
 
-    setStrut(struts, m_widget->effectiveWinId());
+    setStrut(struts);
 }
 
 void StrutManager::releaseStrut()
 {
+    m_updateTimer->stop();
+
     if (m_widget == NULL)
         return;
 
-    ulong struts[12];
+    ulong struts[STRUT_SIZE];
     memset(struts, 0, sizeof struts);
-    setStrut(struts, m_widget->effectiveWinId());
+    setStrut(struts);
+}
+
+void StrutManager::setStrut(ulong *struts)
+{
+    const WId winId = m_widget->effectiveWinId();
+    if (winId == m_lastWinId && memcmp(struts, m_lastStruts, sizeof m_lastStruts) == 0) {
+        return;
+    }
+    m_lastWinId = winId;
+    memcpy(m_lastStruts, struts, sizeof m_lastStruts);
+    /* Updates are coalesced to at most one per event loop iteration and
+       identical values are not written again */
+    UQ_METRIC_COUNT("struts.writes");
+
+    if (strutDebug()) {
+        UQ_DEBUG << "Writing strut for window" << winId;
+    }
+
+    Atom atom = X11Properties::instance()->atom("_NET_WM_STRUT_PARTIAL");
+    XChangeProperty(QX11Info::display(), winId, atom,
+                    XA_CARDINAL, 32, PropModeReplace,
+                    (unsigned char *) struts, STRUT_SIZE);
 }
 
 bool StrutManager::eventFilter(QObject *watched, QEvent *event)
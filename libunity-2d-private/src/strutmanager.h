@@ -26,6 +26,8 @@
 // Unity 2D
 #include "unity2dpanel.h"
 
+class QTimer;
+
 class StrutManager : public QObject
 {
     Q_OBJECT
@@ -85,16 +87,24 @@ protected:
 
 private Q_SLOTS:
     void updateStrut();
+    void reserveStrut();
 
 private:
-    void reserveStrut();
+    /* Number of values of _NET_WM_STRUT_PARTIAL */
+    static const int STRUT_SIZE = 12;
+
     void releaseStrut();
+    void setStrut(ulong *struts);
 
     bool m_enabled;
     QWidget *m_widget;
     Unity2dPanel::Edge m_edge;
     int m_width;
     int m_height;
+    QTimer *m_updateTimer;
+
+    WId m_lastWinId;
+    ulong m_lastStruts[STRUT_SIZE];
 };
 
 #endif /* STRUTMANAGER_H */
\ No newline at end of file
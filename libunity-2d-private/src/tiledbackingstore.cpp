@@ -0,0 +1,371 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Special ordering to bypass evil X11 include
+#include <QBitArray>
+#include <QRegion>
+#include <QX11Info>
+
+// Self
+#include "tiledbackingstore.h"
+
+// Local
+#include <debug_p.h>
+#include <unity2dmetrics.h>
+
+// X11
+#include <X11/Xlib.h>
+#include <X11/Xutil.h>
+#include <X11/extensions/XShm.h>
+
+// libc
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+
+struct TiledBackingStorePrivate
+{
+    QWidget* m_widget;
+    Display* m_display;
+    GC m_gc;
+    XImage* m_ximage;
+    XShmSegmentInfo m_shmInfo;
+    bool m_canUseShm;
+    bool m_useShm;
+    bool m_needsSync;
+    QImage m_image;
+
+    /* Without shared memory: what the X server has been sent, and which of
+       its tiles are still on screen */
+    QImage m_serverCopy;
+    QBitArray m_knownTiles;
+    int m_tileColumns;
+
+    void createImage(const QSize& size);
+    void destroyImage();
+    int tileIndex(int column, int row) const;
+    bool tileChanged(const QRect& tile, int index);
+    void putImage(const QRect& rect);
+};
+
+static bool isLocalDisplay(Display* display)
+{
+    const QByteArray name = DisplayString(display);
+    return name.startsWith(':') || name.startsWith("unix:");
+}
+
+/* XShmAttach fails asynchronously, e.g. with BadAccess when the X server does
+   not share our IPC namespace (containers, sandboxes) */
+static bool s_shmAttachFailed = false;
+static int shmAttachErrorHandler(Display* display, XErrorEvent* event)
+{
+    Q_UNUSED(display);
+    Q_UNUSED(event);
+    s_shmAttachFailed = true;
+    return 0;
+}
+
+static bool attachSharedMemory(Display* display, XShmSegmentInfo* shmInfo)
+{
+    /* Let the errors of the previous requests go to the usual handler */
+    XSync(display, False);
+    s_shmAttachFailed = false;
+    XErrorHandler oldHandler = XSetErrorHandler(shmAttachErrorHandler);
+    const bool attached = XShmAttach(display, shmInfo);
+    XSync(display, False);
+    XSetErrorHandler(oldHandler);
+    return attached && !s_shmAttachFailed;
+}
+
+void TiledBackingStorePrivate::createImage(const QSize& size)
+{
+    destroyImage();
+    if (size.isEmpty()) {
+        return;
+    }
+    Visual* visual = static_cast<Visual*>(QX11Info::appVisual());
+    const int depth = QX11Info::appDepth();
+
+    m_useShm = false;
+    if (m_canUseShm) {
+        m_ximage = XShmCreateImage(m_display, visual, depth, ZPixmap, NULL, &m_shmInfo,
+                                   size.width(), size.height());
+        if (m_ximage != NULL) {
+            m_shmInfo.shmid = shmget(IPC_PRIVATE, m_ximage->bytes_per_line * m_ximage->height,
+                                     IPC_CREAT | 0600);
+            if (m_shmInfo.shmid != -1) {
+                m_shmInfo.shmaddr = static_cast<char*>(shmat(m_shmInfo.shmid, 0, 0));
+                m_shmInfo.readOnly = False;
+                m_useShm = m_shmInfo.shmaddr != reinterpret_cast<char*>(-1)
+                    && attachSharedMemory(m_display, &m_shmInfo);
+                /* Freed as soon as both the X server and us detach */
+                shmctl(m_shmInfo.shmid, IPC_RMID, 0);
+            }
+            if (m_useShm) {
+                m_ximage->data = m_shmInfo.shmaddr;
+                m_image = QImage(reinterpret_cast<uchar*>(m_ximage->data), size.width(), size.height(),
+                                 m_ximage->bytes_per_line, QImage::Format_RGB32);
+                return;
+            }
+            UQ_WARNING << "Could not attach shared memory, falling back to XPutImage";
+            if (m_shmInfo.shmid != -1 && m_shmInfo.shmaddr != reinterpret_cast<char*>(-1)) {
+                shmdt(m_shmInfo.shmaddr);
+            }
+            XDestroyImage(m_ximage);
+            m_ximage = NULL;
+            m_canUseShm = false;
+        }
+    }
+
+    m_image = QImage(size, QImage::Format_RGB32);
+    m_ximage = XCreateImage(m_display, visual, depth, ZPixmap, 0,
+                            reinterpret_cast<char*>(m_image.bits()),
+                            size.width(), size.height(), 32, m_image.bytesPerLine());
+    m_ximage->byte_order = Q_BYTE_ORDER == Q_LITTLE_ENDIAN ? LSBFirst : MSBFirst;
+
+    m_serverCopy = QImage(size, QImage::Format_RGB32);
+    m_tileColumns = (size.width() + TiledBackingStore::TILE_SIZE - 1) / TiledBackingStore::TILE_SIZE;
+    const int tileRows = (size.height() + TiledBackingStore::TILE_SIZE - 1) / TiledBackingStore::TILE_SIZE;
+    m_knownTiles = QBitArray(m_tileColumns * tileRows);
+}
+
+void TiledBackingStorePrivate::destroyImage()
+{
+    if (m_ximage == NULL) {
+        return;
+    }
+    if (m_needsSync) {
+        XSync(m_display, False);
+        m_needsSync = false;
+    }
+    if (m_useShm) {
+        XShmDetach(m_display, &m_shmInfo);
+        XSync(m_display, False);
+        shmdt(m_shmInfo.shmaddr);
+    }
+    /* The pixels belong to m_image or to the shared memory segment */
+    m_ximage->data = NULL;
+    XDestroyImage(m_ximage);
+    m_ximage = NULL;
+    m_image = QImage();
+    m_serverCopy = QImage();
+    m_knownTiles.clear();
+}
+
+int TiledBackingStorePrivate::tileIndex(int column, int row) const
+{
+    return row * m_tileColumns + column;
+}
+
+bool TiledBackingStorePrivate::tileChanged(const QRect& tile, int index)
+{
+    const int bytes = tile.width() * 4;
+    bool changed = !m_knownTiles.testBit(index);
+    for (int y = tile.top(); y <= tile.bottom(); ++y) {
+        const uchar* painted = m_image.constScanLine(y) + tile.left() * 4;
+        uchar* sent = m_serverCopy.scanLine(y) + tile.left() * 4;
+        if (changed || memcmp(painted, sent, bytes) != 0) {
+            changed = true;
+            memcpy(sent, painted, bytes);
+        }
+    }
+    m_knownTiles.setBit(index);
+    return changed;
+}
+
+void TiledBackingStorePrivate::putImage(const QRect& rect)
+{
+    if (m_gc == 0) {
+        m_gc = XCreateGC(m_display, m_widget->winId(), 0, 0);
+    }
+    if (m_useShm) {
+        XShmPutImage(m_display, m_widget->winId(), m_gc, m_ximage,
+                     rect.x(), rect.y(), rect.x(), rect.y(), rect.width(), rect.height(), False);
+        m_needsSync = true;
+    } else {
+        XPutImage(m_display, m_widget->winId(), m_gc, m_ximage,
+                  rect.x(), rect.y(), rect.x(), rect.y(), rect.width(), rect.height());
+    }
+}
+
+TiledBackingStore::TiledBackingStore(QWidget* widget)
+: d(new TiledBackingStorePrivate)
+{
+    d->m_widget = widget;
+    d->m_display = QX11Info::display();
+    d->m_gc = 0;
+    d->m_ximage = NULL;
+    d->m_useShm = false;
+    d->m_needsSync = false;
+    d->m_tileColumns = 0;
+    d->m_canUseShm = isLocalDisplay(d->m_display) && XShmQueryExtension(d->m_display)
+        && qgetenv("UNITY2D_DEBUG_NO_SHM").isEmpty();
+}
+
+TiledBackingStore::~TiledBackingStore()
+{
+    d->destroyImage();
+    if (d->m_gc != 0) {
+        XFreeGC(d->m_display, d->m_gc);
+    }
+    delete d;
+}
+
+bool TiledBackingStore::isSupported()
+{
+    Visual* visual = static_cast<Visual*>(QX11Info::appVisual());
+    if (QX11Info::appDepth() != 24
+        || visual->red_mask != 0xff0000
+        || visual->green_mask != 0xff00
+        || visual->blue_mask != 0xff) {
+        return false;
+    }
+
+    /* The pixels are written as QImage::Format_RGB32, the images of depth 24
+       have to use 32 bits per pixel */
+    Display* display = QX11Info::display();
+    int count = 0;
+    XPixmapFormatValues* formats = XListPixmapFormats(display, &count);
+    bool supported = false;
+    for (int i = 0; i < count; ++i) {
+        if (formats[i].depth == 24) {
+            supported = formats[i].bits_per_pixel == 32;
+            break;
+        }
+    }
+    if (formats != NULL) {
+        XFree(formats);
+    }
+    return supported;
+}
+
+QImage* TiledBackingStore::beginPaint()
+{
+    if (d->m_image.size() != d->m_widget->size()) {
+        d->createImage(d->m_widget->size());
+    }
+    /* Do not paint over pixels the X server is still reading */
+    if (d->m_needsSync) {
+        XSync(d->m_display, False);
+        d->m_needsSync = false;
+    }
+    return &d->m_image;
+}
+
+void TiledBackingStore::flush(const QRegion& region)
+{
+    if (d->m_ximage == NULL) {
+        return;
+    }
+    static Unity2dMetrics::Counter* sentTiles =
+        Unity2dMetrics::instance()->counter("backingstore.tiles_sent");
+    static Unity2dMetrics::Counter* unchangedTiles =
+        Unity2dMetrics::instance()->counter("backingstore.tiles_unchanged");
+
+    const QRect imageRect = d->m_image.rect();
+    const QRect bounds = region.boundingRect() & imageRect;
+    if (bounds.isEmpty()) {
+        return;
+    }
+    const int firstColumn = bounds.left() / TILE_SIZE;
+    const int lastColumn = bounds.right() / TILE_SIZE;
+    const int firstRow = bounds.top() / TILE_SIZE;
+    const int lastRow = bounds.bottom() / TILE_SIZE;
+
+    /* Send runs of dirty tiles of a row in one request */
+    for (int row = firstRow; row <= lastRow; ++row) {
+        int runStart = -1;
+        for (int column = firstColumn; column <= lastColumn + 1; ++column) {
+            bool dirty = false;
+            if (column <= lastColumn) {
+                const QRect tile = QRect(column * TILE_SIZE, row * TILE_SIZE, TILE_SIZE, TILE_SIZE) & imageRect;
+                if (region.intersects(tile)) {
+                    dirty = d->m_useShm || d->tileChanged(tile, d->tileIndex(column, row));
+                    if (!dirty) {
+                        unchangedTiles->increment();
+                    }
+                }
+            }
+            if (dirty && runStart == -1) {
+                runStart = column;
+            } else if (!dirty && runStart != -1) {
+                const QRect run(runStart * TILE_SIZE, row * TILE_SIZE,
+                                (column - runStart) * TILE_SIZE, TILE_SIZE);
+                d->putImage(run & imageRect);
+                sentTiles->increment(column - runStart);
+                runStart = -1;
+            }
+        }
+    }
+}
+
+void TiledBackingStore::invalidate(const QRect& rect)
+{
+    if (d->m_knownTiles.isEmpty()) {
+        return;
+    }
+    const QRect bounds = rect & d->m_image.rect();
+    if (bounds.isEmpty()) {
+        return;
+    }
+    for (int row = bounds.top() / TILE_SIZE; row <= bounds.bottom() / TILE_SIZE; ++row) {
+        for (int column = bounds.left() / TILE_SIZE; column <= bounds.right() / TILE_SIZE; ++column) {
+            d->m_knownTiles.clearBit(d->tileIndex(column, row));
+        }
+    }
+}
+
+bool TiledBackingStore::usesSharedMemory() const
+{
+    return d->m_useShm;
+}
+
+TiledViewport::TiledViewport(QWidget* parent)
+: QWidget(parent)
+, m_backingStore(new TiledBackingStore(this))
+{
+    /* We push the pixels ourselves */
+    setAttribute(Qt::WA_PaintOnScreen);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+TiledViewport::~TiledViewport()
+{
+    delete m_backingStore;
+}
+
+TiledBackingStore* TiledViewport::backingStore() const
+{
+    return m_backingStore;
+}
+
+QPaintEngine* TiledViewport::paintEngine() const
+{
+    return 0;
+}
+
+bool TiledViewport::x11Event(XEvent* event)
+{
+    if (event->type == Expose) {
+        const XExposeEvent& expose = event->xexpose;
+        m_backingStore->invalidate(QRect(expose.x, expose.y, expose.width, expose.height));
+    }
+    return false;
+}
+
+#include "tiledbackingstore.moc"
@@ -0,0 +1,102 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef TILEDBACKINGSTORE_H
+#define TILEDBACKINGSTORE_H
+
+// Qt
+#include <QImage>
+#include <QWidget>
+
+class QRegion;
+struct TiledBackingStorePrivate;
+
+/**
+ * Backing store of a TiledViewport, sent to the X server one tile at a time.
+ *
+ * Qt's raster backing store sends the bounding rectangle of what changed,
+ * which over a network connection (remote X, VNC) means most of the screen
+ * for a spinner and a blinking cursor. This one only sends the tiles that
+ * were painted, with MIT-SHM when the X server is local. When it is not, a
+ * copy of what the server has is kept so that tiles repainted with the same
+ * pixels are not sent again.
+ *
+ * Setting UNITY2D_DEBUG_NO_SHM forces the path without shared memory on a
+ * local X server.
+ */
+class TiledBackingStore
+{
+public:
+    static const int TILE_SIZE = 64;
+
+    TiledBackingStore(QWidget* widget);
+    ~TiledBackingStore();
+
+    /**
+     * Whether the default visual of the display has a pixel format the
+     * store can write to directly
+     */
+    static bool isSupported();
+
+    /**
+     * Returns the image to paint on, the size of the widget. Waits for the
+     * X server to be done with the previous frame first.
+     */
+    QImage* beginPaint();
+
+    /**
+     * Sends the tiles intersecting @p region to the X server
+     */
+    void flush(const QRegion& region);
+
+    /**
+     * Forgets what the X server has in @p rect, e.g. after an expose
+     */
+    void invalidate(const QRect& rect);
+
+    bool usesSharedMemory() const;
+
+private:
+    Q_DISABLE_COPY(TiledBackingStore)
+    TiledBackingStorePrivate* const d;
+};
+
+/**
+ * Viewport of a QGraphicsView painted through a TiledBackingStore instead of
+ * Qt's backing store. The view has to paint it with
+ * QGraphicsView::render() on backingStore()->beginPaint(), Qt cannot paint
+ * on it.
+ */
+class TiledViewport : public QWidget
+{
+    Q_OBJECT
+public:
+    TiledViewport(QWidget* parent = 0);
+    ~TiledViewport();
+
+    TiledBackingStore* backingStore() const;
+
+    virtual QPaintEngine* paintEngine() const;
+
+protected:
+    virtual bool x11Event(XEvent* event);
+
+private:
+    TiledBackingStore* m_backingStore;
+};
+
+#endif /* TILEDBACKINGSTORE_H */
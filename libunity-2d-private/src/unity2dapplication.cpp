@@ -29,6 +29,8 @@
 #include <gscopedpointer.h>
 #include <unity2ddebug.h>
 #include <unity2dtr.h>
+#include <unity2dtrace.h>
+#include <wakeupmonitor.h>
 
 // Qt
 #include <QFont>
@@ -125,8 +127,14 @@ QAccessibleInterface *accessibilityFactory(const QString &classname, QObject *ob
 
 void Unity2dApplication::earlySetup(int& argc, char** argv)
 {
+    Unity2dTrace::init();
+    UQ_TRACE_SCOPE("Unity2dApplication::earlySetup");
+
     // Parts of unity-2d uses GTK so it needs to be initialized
-    gtk_init(&argc, &argv);
+    {
+        UQ_TRACE_SCOPE("gtk_init");
+        gtk_init(&argc, &argv);
+    }
 
     Unity2dDebug::installHandlers();
 
@@ -165,6 +173,10 @@ Unity2dApplication::Unity2dApplication(int& argc, char** argv)
 : QApplication(argc, argv)
 , m_platformFontTracker(new PlatformFontTracker)
 {
+    UQ_TRACE_SCOPE("Unity2dApplication");
+    Unity2dTrace::installDumpHandlers();
+    WakeupMonitor::instance()->start();
+
     /* Configure translations */
     Unity2dTr::init("unity-2d", INSTALL_PREFIX "/share/locale");
 
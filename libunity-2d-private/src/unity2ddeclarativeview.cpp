@@ -19,28 +19,57 @@
 #include <debug_p.h>
 #include <config.h>
 
+#include "adaptiveupdatemode.h"
+#include "declarativecomponentcache.h"
+#include "frameprofiler.h"
 #include "screeninfo.h"
+#include "tiledbackingstore.h"
+#include "unity2dmetrics.h"
+#include "unity2dtrace.h"
 
 #include <QApplication>
 #include <QDebug>
 #include <QDeclarativeEngine>
 #include <QDeclarativeItem>
+#include <QElapsedTimer>
 #include <QGLWidget>
+#include <QPainter>
 #include <QVariant>
+#include <QVector>
 #include <QX11Info>
 #include <QFileInfo>
+#include <QPair>
+#include <QPointer>
 #include <QShowEvent>
 
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
+#include "x11properties.h"
+
+typedef QPair<QPointer<QObject>, QByteArray> FirstFrameCallback;
+static QList<FirstFrameCallback> s_firstFrameCallbacks;
+static bool s_firstFramePainted = false;
+// Started with the first view, to measure the time until its first frame
+static QElapsedTimer s_firstViewTimer;
+
+/* With a tiled viewport, each rectangle of the exposed region is rendered on
+   its own, up to this number: every render() walks the items of the scene */
+static const int MAX_TILED_RENDER_RECTS = 8;
 
 Unity2DDeclarativeView::Unity2DDeclarativeView(QWidget *parent) :
     QGraphicsView(parent),
     m_screenInfo(NULL),
     m_useOpenGL(false),
+    m_adaptiveViewportUpdates(false),
+    m_tiledBackingStore(false),
     m_transparentBackground(false),
-    m_rootItem(NULL)
+    m_rootItem(NULL),
+    m_frameProfiler(NULL),
+    m_adaptiveUpdateMode(NULL)
 {
+    if (!s_firstViewTimer.isValid()) {
+        s_firstViewTimer.start();
+    }
     setScene(&m_scene);
 
     setOptimizationFlags(QGraphicsView::DontSavePainterState);
@@ -59,9 +88,14 @@ Unity2DDeclarativeView::Unity2DDeclarativeView(QWidget *parent) :
         m_useOpenGL = false;
     } else {
         m_useOpenGL = unity2dConfiguration().property("useOpengl").toBool();
+        m_adaptiveViewportUpdates = unity2dConfiguration().property("adaptiveViewportUpdates").toBool();
+        m_tiledBackingStore = unity2dConfiguration().property("tiledBackingStore").toBool();
     }
 
+    m_adaptiveUpdateMode = new AdaptiveUpdateMode(this);
     setupViewport();
+
+    m_frameProfiler = new FrameProfiler(this);
 }
 
 Unity2DDeclarativeView::~Unity2DDeclarativeView()
@@ -91,7 +125,9 @@ void Unity2DDeclarativeView::forceActivateWindow()
 
 void Unity2DDeclarativeView::setSource(const QUrl &source, const QMap<const char*, QVariant> &rootObjectProperties)
 {
-    QDeclarativeComponent* component = new QDeclarativeComponent(engine(), source, this);
+    UQ_TRACE_SCOPE("Unity2DDeclarativeView::setSource");
+    /* Views loading the same source share the compiled component */
+    QDeclarativeComponent* component = DeclarativeComponentCache::instance()->component(source);
     QObject *instance = component->beginCreate(rootContext());
     if (component->isError()) {
         qDebug() << component->errors();
@@ -198,11 +234,20 @@ void Unity2DDeclarativeView::setupViewport()
         /* According to Qt's documentation: "This is the preferred update mode
            for viewports that do not support partial updates, such as QGLWidget [...]"
         */
+        m_adaptiveUpdateMode->setEnabled(false);
         setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
     } else {
-        setViewport(0);
-        /* This is the default update mode */
+        /* Qt cannot send only part of a translucent window, it has to be
+           composited as a whole anyway */
+        if (m_tiledBackingStore && !m_transparentBackground && TiledBackingStore::isSupported()) {
+            setViewport(new TiledViewport);
+        } else {
+            setViewport(0);
+        }
+        /* This is the default update mode. Unless disabled, it then follows
+           what the frames cost. */
         setViewportUpdateMode(QGraphicsView::MinimalViewportUpdate);
+        m_adaptiveUpdateMode->setEnabled(m_adaptiveViewportUpdates);
 
         if (m_transparentBackground) {
             viewport()->setAttribute(Qt::WA_TranslucentBackground, true);
@@ -236,6 +281,87 @@ void Unity2DDeclarativeView::hideEvent(QHideEvent* event)
     Q_EMIT visibleChanged(false);
 }
 
+void Unity2DDeclarativeView::paintEvent(QPaintEvent* event)
+{
+    m_frameProfiler->beginFrame(event->region());
+    m_adaptiveUpdateMode->beginFrame();
+    TiledViewport* tiledViewport = qobject_cast<TiledViewport*>(viewport());
+    if (tiledViewport != NULL) {
+        paintTiled(tiledViewport, event);
+    } else {
+        QGraphicsView::paintEvent(event);
+    }
+    m_adaptiveUpdateMode->endFrame(event->region());
+    m_frameProfiler->endFrame();
+    UQ_METRIC_COUNT("declarativeview.repaints");
+    if (!s_firstFramePainted) {
+        s_firstFramePainted = true;
+        UQ_TRACE_INSTANT("first frame");
+        UQ_METRIC_GAUGE("startup.first_frame_ms", s_firstViewTimer.elapsed());
+        /* Queued, so that the frame is on screen first */
+        Q_FOREACH(const FirstFrameCallback& callback, s_firstFrameCallbacks) {
+            if (!callback.first.isNull()) {
+                QMetaObject::invokeMethod(callback.first, callback.second.constData(), Qt::QueuedConnection);
+            }
+        }
+        s_firstFrameCallbacks.clear();
+    }
+}
+
+void Unity2DDeclarativeView::invokeAfterFirstFrame(QObject* receiver, const char* method)
+{
+    if (s_firstFramePainted) {
+        QMetaObject::invokeMethod(receiver, method, Qt::QueuedConnection);
+    } else {
+        s_firstFrameCallbacks.append(FirstFrameCallback(receiver, method));
+    }
+}
+
+void Unity2DDeclarativeView::paintTiled(TiledViewport* tiledViewport, QPaintEvent* event)
+{
+    QImage* image = tiledViewport->backingStore()->beginPaint();
+    if (image->isNull()) {
+        return;
+    }
+    /* A spinner and a cursor in opposite corners must not make every item
+       in between be painted */
+    QVector<QRect> rects = event->region().rects();
+    if (rects.count() > MAX_TILED_RENDER_RECTS) {
+        rects = QVector<QRect>() << event->region().boundingRect();
+    }
+    QPainter painter(image);
+    painter.setRenderHints(renderHints());
+    Q_FOREACH(const QRect& rect, rects) {
+        painter.setClipRect(rect);
+        painter.fillRect(rect, Qt::black);
+        render(&painter, rect, rect, Qt::IgnoreAspectRatio);
+    }
+    painter.end();
+    tiledViewport->backingStore()->flush(event->region());
+}
+
+void Unity2DDeclarativeView::drawItems(QPainter* painter, int numItems, QGraphicsItem* items[],
+                                       const QStyleOptionGraphicsItem options[])
+{
+    /* Only called when the frame profiler times the items one by one */
+    if (!m_frameProfiler->profilesItems()) {
+        QGraphicsView::drawItems(painter, numItems, items, options);
+        return;
+    }
+    QElapsedTimer timer;
+    for (int i = 0; i < numItems; ++i) {
+        timer.start();
+        QGraphicsView::drawItems(painter, 1, &items[i], &options[i]);
+        m_frameProfiler->addItemTime(items[i], timer.nsecsElapsed() / 1000);
+    }
+}
+
+void Unity2DDeclarativeView::drawForeground(QPainter* painter, const QRectF& rect)
+{
+    QGraphicsView::drawForeground(painter, rect);
+    m_frameProfiler->drawOverlay(painter);
+}
+
 void Unity2DDeclarativeView::keyPressEvent(QKeyEvent* event)
 {
     QApplication::sendEvent(scene(), event);
@@ -255,8 +381,7 @@ void Unity2DDeclarativeView::forceActivateWindow(WId window, QWidget *w)
        ref.: http://permalink.gmane.org/gmane.comp.lib.qt.general/4733
     */
     Display* display = QX11Info::display();
-    Atom net_wm_active_window = XInternAtom(display, "_NET_ACTIVE_WINDOW",
-                                            False);
+    Atom net_wm_active_window = X11Properties::instance()->atom("_NET_ACTIVE_WINDOW");
     XEvent xev;
     xev.xclient.type = ClientMessage;
     xev.xclient.send_event = True;
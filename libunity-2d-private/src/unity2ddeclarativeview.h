@@ -23,7 +23,10 @@
 #include <QUrl>
 #include <QVariant>
 
+class AdaptiveUpdateMode;
+class FrameProfiler;
 class ScreenInfo;
+class TiledViewport;
 
 class QDeclarativeContext;
 class QDeclarativeEngine;
@@ -63,6 +66,13 @@ public:
 
     Q_INVOKABLE virtual void forceActivateWindow();
 
+    /**
+     * Invokes the slot @p method of @p receiver once a declarative view of
+     * the process has painted its first frame, or soon if one already has.
+     * For work that can wait until something is on screen.
+     */
+    static void invokeAfterFirstFrame(QObject* receiver, const char* method);
+
 Q_SIGNALS:
     void useOpenGLChanged(bool);
     void transparentBackgroundChanged(bool);
@@ -77,6 +87,10 @@ protected:
     virtual void moveEvent(QMoveEvent* event);
     virtual void showEvent(QShowEvent *event);
     virtual void hideEvent(QHideEvent* event);
+    virtual void paintEvent(QPaintEvent* event);
+    virtual void drawItems(QPainter* painter, int numItems, QGraphicsItem* items[],
+                           const QStyleOptionGraphicsItem options[]);
+    virtual void drawForeground(QPainter* painter, const QRectF& rect);
     virtual void keyPressEvent(QKeyEvent* event);
     virtual void keyReleaseEvent(QKeyEvent* event);
 
@@ -87,13 +101,20 @@ protected:
 private Q_SLOTS:
     void resizeToRootObject();
 
+private:
+    void paintTiled(TiledViewport* viewport, QPaintEvent* event);
+
 private:
     bool m_useOpenGL;
+    bool m_adaptiveViewportUpdates;
+    bool m_tiledBackingStore;
     bool m_transparentBackground;
     QUrl m_source;
 
     QGraphicsScene m_scene;
     QDeclarativeItem* m_rootItem;
+    FrameProfiler* m_frameProfiler;
+    AdaptiveUpdateMode* m_adaptiveUpdateMode;
 };
 
 Q_DECLARE_METATYPE(Unity2DDeclarativeView*)
@@ -0,0 +1,163 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "unity2dmetrics.h"
+
+// Qt
+#include <QMutexLocker>
+
+// From 50us to a quarter of a second: a frame lasts 16ms, anything past 250ms
+// is a visible freeze anyway
+static const qint64 BUCKET_BOUNDS[] = {
+    50, 100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000
+};
+static const int BUCKET_BOUND_COUNT = sizeof(BUCKET_BOUNDS) / sizeof(BUCKET_BOUNDS[0]);
+
+Unity2dMetrics::Histogram::Histogram(const QList<qint64>& bounds)
+: m_bounds(bounds.toVector())
+, m_count(0)
+, m_sum(0)
+, m_max(0)
+, m_buckets(bounds.count() + 1, 0)
+{
+}
+
+void Unity2dMetrics::Histogram::record(qint64 value)
+{
+    int bucket = 0;
+    while (bucket < m_bounds.count() && value > m_bounds.at(bucket)) {
+        ++bucket;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    ++m_count;
+    m_sum += value;
+    m_max = qMax(m_max, value);
+    ++m_buckets[bucket];
+}
+
+QVariantMap Unity2dMetrics::Histogram::toVariantMap() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVariantList bounds;
+    Q_FOREACH(qint64 bound, m_bounds) {
+        bounds << bound;
+    }
+    QVariantList buckets;
+    Q_FOREACH(qint64 count, m_buckets) {
+        buckets << count;
+    }
+    QVariantMap map;
+    map["bounds"] = bounds;
+    map["count"] = m_count;
+    map["sum"] = m_sum;
+    map["max"] = m_max;
+    map["buckets"] = buckets;
+    return map;
+}
+
+Unity2dMetrics::Unity2dMetrics()
+{
+}
+
+Unity2dMetrics::~Unity2dMetrics()
+{
+    qDeleteAll(m_counters);
+    qDeleteAll(m_gauges);
+    qDeleteAll(m_histograms);
+}
+
+Unity2dMetrics* Unity2dMetrics::instance()
+{
+    static Unity2dMetrics metrics;
+    return &metrics;
+}
+
+template <class T>
+static T* findOrCreate(QMap<QByteArray, T*>& map, const char* name)
+{
+    T*& metric = map[name];
+    if (metric == NULL) {
+        metric = new T;
+    }
+    return metric;
+}
+
+Unity2dMetrics::Counter* Unity2dMetrics::counter(const char* name)
+{
+    QMutexLocker locker(&m_mutex);
+    return findOrCreate(m_counters, name);
+}
+
+Unity2dMetrics::Gauge* Unity2dMetrics::gauge(const char* name)
+{
+    QMutexLocker locker(&m_mutex);
+    return findOrCreate(m_gauges, name);
+}
+
+Unity2dMetrics::Histogram* Unity2dMetrics::histogram(const char* name, const QList<qint64>& bounds)
+{
+    QMutexLocker locker(&m_mutex);
+    Histogram*& histogram = m_histograms[name];
+    if (histogram == NULL) {
+        histogram = new Histogram(bounds.isEmpty() ? bucketBounds() : bounds);
+    }
+    return histogram;
+}
+
+QList<qint64> Unity2dMetrics::bucketBounds()
+{
+    QList<qint64> bounds;
+    for (int i = 0; i < BUCKET_BOUND_COUNT; ++i) {
+        bounds << BUCKET_BOUNDS[i];
+    }
+    return bounds;
+}
+
+QVariantMap Unity2dMetrics::counters() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVariantMap map;
+    QMap<QByteArray, Counter*>::const_iterator it;
+    for (it = m_counters.constBegin(); it != m_counters.constEnd(); ++it) {
+        map[QString::fromLatin1(it.key())] = it.value()->value();
+    }
+    return map;
+}
+
+QVariantMap Unity2dMetrics::gauges() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVariantMap map;
+    QMap<QByteArray, Gauge*>::const_iterator it;
+    for (it = m_gauges.constBegin(); it != m_gauges.constEnd(); ++it) {
+        map[QString::fromLatin1(it.key())] = it.value()->value();
+    }
+    return map;
+}
+
+QVariantMap Unity2dMetrics::histograms() const
+{
+    QMutexLocker locker(&m_mutex);
+    QVariantMap map;
+    QMap<QByteArray, Histogram*>::const_iterator it;
+    for (it = m_histograms.constBegin(); it != m_histograms.constEnd(); ++it) {
+        map[QString::fromLatin1(it.key())] = it.value()->toVariantMap();
+    }
+    return map;
+}
@@ -0,0 +1,161 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UNITY2DMETRICS_H
+#define UNITY2DMETRICS_H
+
+// Qt
+#include <QAtomicInt>
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutex>
+#include <QVariant>
+#include <QVector>
+
+/**
+ * Process wide registry of runtime metrics: counters, gauges and latency
+ * histograms. It is published on D-Bus by MetricsDBus.
+ *
+ * Metrics are created on first use and live as long as the process. Use the
+ * UQ_METRIC_* macros from hot paths: they look the metric up only once per
+ * call site, after which recording is a single atomic operation (or an
+ * uncontended lock for histograms). Recording is safe from any thread, image
+ * providers in particular run outside of the GUI thread.
+ */
+class Unity2dMetrics
+{
+public:
+    /**
+     * Monotonically increasing value, wraps around after 2^32
+     */
+    class Counter
+    {
+    public:
+        Counter() : m_value(0) {}
+        void increment(int count = 1) { m_value.fetchAndAddRelaxed(count); }
+        uint value() const { return uint(int(m_value)); }
+    private:
+        QAtomicInt m_value;
+    };
+
+    /**
+     * Value that goes up and down, e.g. the size of a cache
+     */
+    class Gauge
+    {
+    public:
+        Gauge() : m_value(0) {}
+        void set(int value) { m_value.fetchAndStoreRelaxed(value); }
+        void add(int delta) { m_value.fetchAndAddRelaxed(delta); }
+        int value() const { return m_value; }
+    private:
+        QAtomicInt m_value;
+    };
+
+    /**
+     * Distribution of values in buckets with fixed upper bounds. Values are
+     * durations in microseconds unless the histogram was created with its own
+     * bounds.
+     */
+    class Histogram
+    {
+    public:
+        Histogram(const QList<qint64>& bounds);
+        void record(qint64 value);
+        QVariantMap toVariantMap() const;
+    private:
+        const QVector<qint64> m_bounds;
+        mutable QMutex m_mutex;
+        qint64 m_count;
+        qint64 m_sum;
+        qint64 m_max;
+        QVector<qint64> m_buckets;
+    };
+
+    /**
+     * Records the time spent until the end of the current block
+     */
+    class LatencyScope
+    {
+    public:
+        LatencyScope(Histogram* histogram) : m_histogram(histogram) { m_timer.start(); }
+        ~LatencyScope() { m_histogram->record(m_timer.nsecsElapsed() / 1000); }
+    private:
+        Histogram* m_histogram;
+        QElapsedTimer m_timer;
+    };
+
+    static Unity2dMetrics* instance();
+
+    Counter* counter(const char* name);
+    Gauge* gauge(const char* name);
+    /**
+     * Returns the histogram @p name, created with the upper bounds @p bounds
+     * if it does not exist yet, or with bucketBounds() if @p bounds is empty
+     */
+    Histogram* histogram(const char* name, const QList<qint64>& bounds = QList<qint64>());
+
+    /**
+     * Default upper bounds of the histogram buckets, in microseconds. The last
+     * bucket has no upper bound.
+     */
+    static QList<qint64> bucketBounds();
+
+    QVariantMap counters() const;
+    QVariantMap gauges() const;
+    QVariantMap histograms() const;
+
+private:
+    Unity2dMetrics();
+    ~Unity2dMetrics();
+    Q_DISABLE_COPY(Unity2dMetrics)
+
+    mutable QMutex m_mutex;
+    QMap<QByteArray, Counter*> m_counters;
+    QMap<QByteArray, Gauge*> m_gauges;
+    QMap<QByteArray, Histogram*> m_histograms;
+};
+
+#define _UQ_METRIC_CONCAT2(a, b) a##b
+#define _UQ_METRIC_CONCAT(a, b) _UQ_METRIC_CONCAT2(a, b)
+
+// Increments the counter @p name
+#define UQ_METRIC_COUNT(name) do { \
+    static Unity2dMetrics::Counter* _counter = Unity2dMetrics::instance()->counter(name); \
+    _counter->increment(); \
+} while (0)
+
+// Sets the gauge @p name to @p value
+#define UQ_METRIC_GAUGE(name, value) do { \
+    static Unity2dMetrics::Gauge* _gauge = Unity2dMetrics::instance()->gauge(name); \
+    _gauge->set(value); \
+} while (0)
+
+// Records @p value in the histogram @p name
+#define UQ_METRIC_RECORD(name, value) do { \
+    static Unity2dMetrics::Histogram* _histogram = Unity2dMetrics::instance()->histogram(name); \
+    _histogram->record(value); \
+} while (0)
+
+// Records the time spent until the end of the current block in the histogram @p name
+#define UQ_METRIC_LATENCY(name) \
+    static Unity2dMetrics::Histogram* _UQ_METRIC_CONCAT(__unity2dHistogram, __LINE__) = \
+        Unity2dMetrics::instance()->histogram(name); \
+    Unity2dMetrics::LatencyScope _UQ_METRIC_CONCAT(__unity2dLatencyScope, __LINE__)( \
+        _UQ_METRIC_CONCAT(__unity2dHistogram, __LINE__))
+
+#endif /* UNITY2DMETRICS_H */
@@ -24,6 +24,8 @@
 #include "strutmanager.h"
 #include <debug_p.h>
 #include <indicatorsmanager.h>
+#include <unity2dmetrics.h>
+#include <unity2dtrace.h>
 
 // Qt
 #include <QApplication>
@@ -181,6 +183,13 @@ void Unity2dPanel::slotWorkAreaResized(int screen)
 
 void Unity2dPanel::paintEvent(QPaintEvent* event)
 {
+    UQ_METRIC_COUNT("panel.repaints");
+    static bool firstFramePainted = false;
+    if (!firstFramePainted) {
+        firstFramePainted = true;
+        UQ_TRACE_INSTANT("first panel frame");
+    }
+
     // Necessary because Oxygen thinks it knows better what to paint in the background
     QPainter painter(this);
     painter.setCompositionMode(QPainter::CompositionMode_Source);
@@ -0,0 +1,221 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "unity2dtrace.h"
+
+// Qt
+#include <QAtomicInt>
+#include <QCoreApplication>
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSocketNotifier>
+
+// libc
+#include <cstdio>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace Unity2dTrace
+{
+
+bool s_enabled = false;
+
+// Older events get overwritten when a thread records more than that
+static const int BUFFER_SIZE = 16384;
+
+struct Event
+{
+    const char* name;
+    qint64 timestamp;
+    qint64 duration;
+    char phase;
+};
+
+/* Only written by its own thread, so recording does not need any lock. The
+   event is filled before the counter gets incremented, so that dump() never
+   reads a half written event. */
+struct ThreadBuffer
+{
+    long tid;
+    QAtomicInt written;
+    Event events[BUFFER_SIZE];
+};
+
+static __thread ThreadBuffer* t_buffer = NULL;
+
+// Only locked when a thread records its first event, and when dumping
+static QMutex s_buffersMutex;
+static QList<ThreadBuffer*> s_buffers;
+
+static QByteArray s_dir;
+static int s_signalFds[2] = { -1, -1 };
+
+static ThreadBuffer* threadBuffer()
+{
+    if (t_buffer == NULL) {
+        t_buffer = new ThreadBuffer;
+        t_buffer->tid = syscall(SYS_gettid);
+        QMutexLocker locker(&s_buffersMutex);
+        s_buffers.append(t_buffer);
+    }
+    return t_buffer;
+}
+
+static void addEvent(const char* name, qint64 timestamp, qint64 duration, char phase)
+{
+    ThreadBuffer* buffer = threadBuffer();
+    Event& event = buffer->events[int(buffer->written) % BUFFER_SIZE];
+    event.name = name;
+    event.timestamp = timestamp;
+    event.duration = duration;
+    event.phase = phase;
+    buffer->written.fetchAndAddRelease(1);
+}
+
+void init()
+{
+    s_dir = qgetenv("UNITY2D_TRACE");
+    s_enabled = !s_dir.isEmpty();
+}
+
+qint64 now()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return qint64(ts.tv_sec) * 1000000 + ts.tv_nsec / 1000;
+}
+
+void addComplete(const char* name, qint64 start, qint64 duration)
+{
+    addEvent(name, start, duration, 'X');
+}
+
+void addInstant(const char* name)
+{
+    addEvent(name, now(), 0, 'i');
+}
+
+static void writeEscaped(FILE* file, const char* string)
+{
+    for (const char* ptr = string; *ptr; ++ptr) {
+        if (*ptr == '"' || *ptr == '\\') {
+            fputc('\\', file);
+        }
+        fputc(*ptr, file);
+    }
+}
+
+void dump()
+{
+    if (!s_enabled) {
+        return;
+    }
+    const QByteArray fileName = s_dir + "/"
+        + QCoreApplication::applicationFilePath().section("/", -1).toLocal8Bit()
+        + "-" + QByteArray::number(QCoreApplication::applicationPid()) + ".json";
+    FILE* file = fopen(fileName.constData(), "w");
+    if (file == NULL) {
+        qWarning("Could not write trace to %s", fileName.constData());
+        return;
+    }
+
+    const qint64 pid = QCoreApplication::applicationPid();
+    fputs("{\"traceEvents\":[\n", file);
+    fprintf(file, "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%lld,\"args\":{\"name\":\"", pid);
+    writeEscaped(file, QCoreApplication::applicationName().toUtf8().constData());
+    fputs("\"}}", file);
+
+    QMutexLocker locker(&s_buffersMutex);
+    Q_FOREACH(ThreadBuffer* buffer, s_buffers) {
+        const int written = buffer->written.fetchAndAddAcquire(0);
+        const int first = qMax(0, written - BUFFER_SIZE);
+        for (int i = first; i < written; ++i) {
+            const Event& event = buffer->events[i % BUFFER_SIZE];
+            fputs(",\n{\"name\":\"", file);
+            writeEscaped(file, event.name);
+            fprintf(file, "\",\"cat\":\"unity-2d\",\"ph\":\"%c\",\"ts\":%lld,\"pid\":%lld,\"tid\":%ld",
+                    event.phase, event.timestamp, pid, buffer->tid);
+            if (event.phase == 'X') {
+                fprintf(file, ",\"dur\":%lld", event.duration);
+            } else {
+                fputs(",\"s\":\"t\"", file);
+            }
+            fputc('}', file);
+        }
+    }
+    fputs("\n]}\n", file);
+    fclose(file);
+    qDebug("Trace written to %s", fileName.constData());
+}
+
+/* Signal handlers cannot do much safely: forward the signal to the event loop
+   through a socket */
+static void onDumpSignal(int)
+{
+    char byte = 1;
+    ssize_t ret = write(s_signalFds[0], &byte, sizeof(byte));
+    Q_UNUSED(ret);
+}
+
+class DumpNotifier : public QSocketNotifier
+{
+    Q_OBJECT
+public:
+    DumpNotifier(int fd)
+    : QSocketNotifier(fd, QSocketNotifier::Read, QCoreApplication::instance())
+    {
+        connect(this, SIGNAL(activated(int)), SLOT(onActivated(int)));
+    }
+
+private Q_SLOTS:
+    void onActivated(int fd)
+    {
+        char byte;
+        ssize_t ret = read(fd, &byte, sizeof(byte));
+        Q_UNUSED(ret);
+        dump();
+    }
+};
+
+void installDumpHandlers()
+{
+    if (!s_enabled) {
+        return;
+    }
+    qAddPostRoutine(dump);
+
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, s_signalFds) != 0) {
+        qWarning("Could not create the trace signal socket, the trace will only be written at exit");
+        return;
+    }
+    new DumpNotifier(s_signalFds[1]);
+
+    struct sigaction action;
+    action.sa_handler = onDumpSignal;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR1, &action, NULL);
+}
+
+} // namespace
+
+#include "unity2dtrace.moc"
@@ -0,0 +1,132 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef UNITY2DTRACE_H
+#define UNITY2DTRACE_H
+
+// Qt
+#include <QtGlobal>
+
+/**
+ * Lightweight tracer to find out where time goes, at startup in particular.
+ *
+ * Set UNITY2D_TRACE to a directory to enable it: events are then recorded
+ * into a ring buffer per thread and written to
+ * <directory>/<binary>-<pid>.json in the Chrome trace event format (open it
+ * in chrome://tracing) when the process exits or receives SIGUSR1.
+ *
+ * Use the UQ_TRACE_* macros rather than the functions: they compile to
+ * nothing when unity-2d is built with -DENABLE_TRACE=OFF, in which case the
+ * tracer itself is not built and init() and installDumpHandlers() do
+ * nothing. Event names must be string literals, they are not copied.
+ */
+#ifdef UNITY2D_TRACE_ENABLED
+
+namespace Unity2dTrace
+{
+
+extern bool s_enabled;
+
+inline bool isEnabled()
+{
+    return s_enabled;
+}
+
+/**
+ * Starts recording if UNITY2D_TRACE is set. Called by
+ * Unity2dApplication::earlySetup().
+ */
+void init();
+
+/**
+ * Dumps the trace on SIGUSR1 and at exit. Needs a QCoreApplication, called
+ * by the Unity2dApplication constructor.
+ */
+void installDumpHandlers();
+
+/**
+ * Monotonic time in microseconds
+ */
+qint64 now();
+
+void addComplete(const char* name, qint64 start, qint64 duration);
+void addInstant(const char* name);
+
+/**
+ * Writes all the recorded events to the trace file
+ */
+void dump();
+
+class Scope
+{
+public:
+    Scope(const char* name)
+    : m_name(name)
+    , m_start(isEnabled() ? now() : 0)
+    {
+    }
+
+    ~Scope()
+    {
+        if (isEnabled()) {
+            addComplete(m_name, m_start, now() - m_start);
+        }
+    }
+
+private:
+    const char* m_name;
+    qint64 m_start;
+};
+
+} // namespace
+
+#define _UQ_TRACE_CONCAT2(a, b) a##b
+#define _UQ_TRACE_CONCAT(a, b) _UQ_TRACE_CONCAT2(a, b)
+
+// Records the time spent until the end of the current block
+#define UQ_TRACE_SCOPE(name) Unity2dTrace::Scope _UQ_TRACE_CONCAT(__unity2dTraceScope, __LINE__)(name)
+
+// Records a point in time, e.g. the first painted frame
+#define UQ_TRACE_INSTANT(name) do { if (Unity2dTrace::isEnabled()) Unity2dTrace::addInstant(name); } while (0)
+
+#else
+
+/* The tracer is not built in, UNITY2D_TRACE is ignored */
+namespace Unity2dTrace
+{
+
+inline bool isEnabled()
+{
+    return false;
+}
+
+inline void init()
+{
+}
+
+inline void installDumpHandlers()
+{
+}
+
+} // namespace
+
+#define UQ_TRACE_SCOPE(name) do {} while (0)
+#define UQ_TRACE_INSTANT(name) do {} while (0)
+
+#endif
+
+#endif /* UNITY2DTRACE_H */
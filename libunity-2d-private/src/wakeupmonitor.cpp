@@ -0,0 +1,112 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Self
+#include "wakeupmonitor.h"
+
+// Local
+#include "unity2dmetrics.h"
+
+// libunity-2d
+#include <debug_p.h>
+
+// Qt
+#include <QAbstractEventDispatcher>
+#include <QCoreApplication>
+
+WakeupMonitor::WakeupMonitor()
+: m_second(0)
+, m_blocked(false)
+{
+    for (int i = 0; i < WINDOW; ++i) {
+        m_counts[i] = 0;
+    }
+}
+
+WakeupMonitor* WakeupMonitor::instance()
+{
+    static WakeupMonitor monitor;
+    return &monitor;
+}
+
+void WakeupMonitor::start()
+{
+    if (m_clock.isValid()) {
+        return;
+    }
+    QAbstractEventDispatcher* dispatcher = QAbstractEventDispatcher::instance(QCoreApplication::instance()->thread());
+    if (dispatcher == NULL) {
+        UQ_WARNING << "No event dispatcher, wakeups will not be counted";
+        return;
+    }
+    connect(dispatcher, SIGNAL(aboutToBlock()), SLOT(onAboutToBlock()), Qt::DirectConnection);
+    connect(dispatcher, SIGNAL(awake()), SLOT(onAwake()), Qt::DirectConnection);
+    m_clock.start();
+}
+
+void WakeupMonitor::onAboutToBlock()
+{
+    m_blocked = true;
+}
+
+void WakeupMonitor::onAwake()
+{
+    /* awake() is also emitted when processing events without waiting, only
+       count the wakeups that follow a wait */
+    if (!m_blocked) {
+        return;
+    }
+    m_blocked = false;
+    advance();
+    ++m_counts[m_second % WINDOW];
+    UQ_METRIC_COUNT("process.wakeups");
+}
+
+void WakeupMonitor::advance()
+{
+    const qint64 now = m_clock.elapsed() / 1000;
+    if (now - m_second >= WINDOW) {
+        for (int i = 0; i < WINDOW; ++i) {
+            m_counts[i] = 0;
+        }
+    } else {
+        for (qint64 second = m_second + 1; second <= now; ++second) {
+            m_counts[second % WINDOW] = 0;
+        }
+    }
+    m_second = now;
+}
+
+qreal WakeupMonitor::wakeupsPerSecond()
+{
+    if (!m_clock.isValid()) {
+        return 0;
+    }
+    advance();
+    /* The current second is not over yet */
+    const int seconds = qMin<qint64>(m_second, WINDOW - 1);
+    if (seconds == 0) {
+        return 0;
+    }
+    int wakeups = 0;
+    for (qint64 second = m_second - seconds; second < m_second; ++second) {
+        wakeups += m_counts[second % WINDOW];
+    }
+    return qreal(wakeups) / seconds;
+}
+
+#include "wakeupmonitor.moc"
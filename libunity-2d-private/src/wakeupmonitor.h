@@ -0,0 +1,71 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef WAKEUPMONITOR_H
+#define WAKEUPMONITOR_H
+
+// Qt
+#include <QElapsedTimer>
+#include <QObject>
+
+/**
+ * Counts how often the event loop of the process wakes up after having
+ * blocked, which is what keeps the CPU out of its idle states on a laptop.
+ *
+ * Every wakeup increments the process.wakeups counter. The rate over the
+ * last complete seconds is returned by wakeupsPerSecond(), and by
+ * WakeupsPerSecond on the /Metrics D-Bus object. It is computed when asked
+ * for, measuring does not need a timer of its own.
+ */
+class WakeupMonitor : public QObject
+{
+    Q_OBJECT
+public:
+    static const int WINDOW = 10; // seconds
+
+    static WakeupMonitor* instance();
+
+    /**
+     * Starts counting the wakeups of the event dispatcher of the GUI thread.
+     * The application has to exist already.
+     */
+    void start();
+
+    /**
+     * Average number of wakeups per second over the complete seconds among
+     * the last WINDOW ones, the current second is left out
+     */
+    qreal wakeupsPerSecond();
+
+private Q_SLOTS:
+    void onAboutToBlock();
+    void onAwake();
+
+private:
+    WakeupMonitor();
+    Q_DISABLE_COPY(WakeupMonitor)
+
+    void advance();
+
+    QElapsedTimer m_clock;
+    qint64 m_second;
+    bool m_blocked;
+    // Wakeups per second, indexed by second modulo WINDOW
+    int m_counts[WINDOW];
+};
+
+#endif /* WAKEUPMONITOR_H */
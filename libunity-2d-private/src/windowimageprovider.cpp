@@ -20,7 +20,9 @@
 #include <QImage>
 
 #include "windowimageprovider.h"
+#include "x11properties.h"
 #include <debug_p.h>
+#include <unity2dmetrics.h>
 
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
@@ -63,35 +65,18 @@ WindowImageProvider::~WindowImageProvider()
 */
 static bool tryGetWindowCapture(Window xwindow, XID *pixmap)
 {
-  /* Intern the atom only once, as its value never changes */
-  static Atom atom = XInternAtom(QX11Info::display(),
-                                 "_METACITY_WINDOW_CAPTURE", False);
-  Atom type;
-  int format;
-  unsigned long nitems;
-  unsigned long bytes_after;
-  Pixmap *data;
-  int result;
+  X11Properties* properties = X11Properties::instance();
+  Atom atom = properties->atom("_METACITY_WINDOW_CAPTURE");
 
   *pixmap = 0;
 
-  type = None;
-  result = XGetWindowProperty (QX11Info::display(),
-                               xwindow, atom,
-                               0, LONG_MAX,
-                               False, XA_PIXMAP, &type, &format, &nitems,
-                               &bytes_after, (unsigned char**)&data);
-  if (result != Success) {
-     return false;
-  }
-
-  if (type != XA_PIXMAP) {
-      XFree (data);
+  /* The property is cached until metacity updates it */
+  QVector<ulong> data = properties->property(xwindow, atom, XA_PIXMAP).toULongs();
+  if (data.isEmpty()) {
       return false;
   }
 
-  *pixmap = *data;
-  XFree (data);
+  *pixmap = data.first();
   return true;
 }
 
@@ -99,6 +84,7 @@ QImage WindowImageProvider::requestImage(const QString &id,
                                               QSize *size,
                                               const QSize &requestedSize)
 {
+    UQ_METRIC_LATENCY("imageprovider.window.latency");
     QString windowIds = id;
 
     /* Split the id on the character "|". The first part is the window ID of
@@ -143,6 +129,7 @@ QPixmap WindowImageProvider::getWindowPixmap(Window frameWindowId,
 {
     XWindowAttributes attr;
 
+    UQ_METRIC_COUNT("x11.roundtrips");
     XGetWindowAttributes(QX11Info::display(), frameWindowId, &attr);
     if (attr.map_state == IsViewable) {
         return QPixmap::fromX11Pixmap(frameWindowId);
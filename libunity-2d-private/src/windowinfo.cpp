@@ -23,6 +23,7 @@
 #include "bamf-window.h"
 
 #include "windowinfo.h"
+#include "unity2dmetrics.h"
 
 #include <QApplication>
 #include <QDesktopWidget>
@@ -94,6 +95,7 @@ unsigned int WindowInfo::findTopmostAncestor(unsigned int xid)
     do {
         topmost = parent;
 
+        UQ_METRIC_COUNT("x11.roundtrips");
         if (XQueryTree (QX11Info::display(), topmost, &root,
                         &parent, &children, &nchildren) == 0) {
             /* In case the query fails, fallback to our original xid */
@@ -28,6 +28,7 @@
 
 // libunity-2d
 #include <unity2dtr.h>
+#include <unity2dmetrics.h>
 #include <debug_p.h>
 
 Workspaces::Workspaces()
@@ -100,12 +101,15 @@ Workspaces::activate()
 
     if (compiz.isValid()) {
         Qt::HANDLE root = QX11Info::appRootWindow();
+        UQ_METRIC_COUNT("dbus.calls");
         compiz.asyncCall("activate", "root", static_cast<int>(root));
     } else {
         QDBusInterface spread("com.canonical.Unity2d.Spread", "/Spread",
                               "com.canonical.Unity2d.Spread");
+        UQ_METRIC_COUNT("dbus.blocking_calls");
         QDBusReply<bool> isShown = spread.call("IsShown");
         if (isShown.isValid()) {
+            UQ_METRIC_COUNT("dbus.calls");
             if (isShown.value() == true) {
                 spread.asyncCall("FilterByApplication", QString());
             } else {
@@ -1,6 +1,7 @@
 #include "workspacesinfo.h"
 #include "desktopinfo.h"
 #include "signalwaiter.h"
+#include "x11properties.h"
 #include <debug_p.h>
 
 extern "C" {
@@ -31,6 +32,12 @@ WorkspacesInfo::WorkspacesInfo(QObject *parent) :
 {
     WorkspacesInfo::internX11Atoms();
 
+    /* Send all the requests at once instead of waiting for each reply */
+    X11Properties* properties = X11Properties::instance();
+    properties->prefetch(QX11Info::appRootWindow(), _NET_NUMBER_OF_DESKTOPS, XA_CARDINAL);
+    properties->prefetch(QX11Info::appRootWindow(), _NET_DESKTOP_LAYOUT, XA_CARDINAL);
+    properties->prefetch(QX11Info::appRootWindow(), _NET_CURRENT_DESKTOP, XA_CARDINAL);
+
     /* Setup an low-level event filter so that we can get X11 events directly,
        then ask X11 to notify us of property changes on the root window. This
        will include notiication on workspace geometry changes.
@@ -46,15 +53,10 @@ WorkspacesInfo::WorkspacesInfo(QObject *parent) :
 /* X11 Atoms never change, so let's just avoid repeating these calls more than once */
 void WorkspacesInfo::internX11Atoms()
 {
-    _NET_DESKTOP_LAYOUT = XInternAtom(QX11Info::display(),
-                                      "_NET_DESKTOP_LAYOUT",
-                                      False);
-    _NET_NUMBER_OF_DESKTOPS = XInternAtom(QX11Info::display(),
-                                          "_NET_NUMBER_OF_DESKTOPS",
-                                          False);
-    _NET_CURRENT_DESKTOP = XInternAtom(QX11Info::display(),
-                                       "_NET_CURRENT_DESKTOP",
-                                       False);
+    X11Properties* properties = X11Properties::instance();
+    _NET_DESKTOP_LAYOUT = properties->atom("_NET_DESKTOP_LAYOUT");
+    _NET_NUMBER_OF_DESKTOPS = properties->atom("_NET_NUMBER_OF_DESKTOPS");
+    _NET_CURRENT_DESKTOP = properties->atom("_NET_CURRENT_DESKTOP");
 }
 
 bool WorkspacesInfo::globalEventFilter(void* message)
@@ -72,6 +74,9 @@ bool WorkspacesInfo::globalEventFilter(void* message)
 
     XPropertyEvent* notify = (XPropertyEvent*) event;
 
+    /* Our filter may run before X11Properties gets to see the event */
+    X11Properties::instance()->invalidate(notify->window, notify->atom);
+
     if (notify->atom == _NET_DESKTOP_LAYOUT ||
         notify->atom == _NET_NUMBER_OF_DESKTOPS) {
         DesktopInfo::instance()->workspaces()->updateWorkspaceGeometry();
@@ -136,11 +141,9 @@ void WorkspacesInfo::updateWorkspaceGeometry()
 
 bool WorkspacesInfo::getWorkspaceCountFromX(int& workspaceCount)
 {
-    unsigned long *result;
-    result = getX11IntProperty(_NET_NUMBER_OF_DESKTOPS, 1);
-    if (result != NULL) {
+    QVector<ulong> result = getX11IntProperty(_NET_NUMBER_OF_DESKTOPS, 1);
+    if (!result.isEmpty()) {
         workspaceCount = result[0];
-        XFree(result);
         return true;
     } else {
         return false;
@@ -149,14 +152,12 @@ bool WorkspacesInfo::getWorkspaceCountFromX(int& workspaceCount)
 
 bool WorkspacesInfo::getWorkspaceLayoutFromX(Orientation& orientation, int& columns, int& rows, Corner& startingCorner)
 {
-    unsigned long *result;
-    result = getX11IntProperty(_NET_DESKTOP_LAYOUT, 4);
-    if (result != NULL) {
+    QVector<ulong> result = getX11IntProperty(_NET_DESKTOP_LAYOUT, 4);
+    if (result.size() >= 4) {
         orientation = (Orientation) result[0];
         columns = result[1];
         rows = result[2];
         startingCorner = (Corner) result[3];
-        XFree(result);
         return true;
     } else {
         return false;
@@ -207,14 +208,12 @@ void WorkspacesInfo::updateWorkspaceGeometryProperties(int workspaceCount, Orien
 void WorkspacesInfo::updateCurrentWorkspace()
 {
     int currentWorkspace;
-    unsigned long *result;
-    result = getX11IntProperty(_NET_CURRENT_DESKTOP, 1);
-    if (result == NULL) {
+    QVector<ulong> result = getX11IntProperty(_NET_CURRENT_DESKTOP, 1);
+    if (result.isEmpty()) {
         currentWorkspace = 0;
     } else {
         currentWorkspace = result[0];
     }
-    XFree(result);
 
     if (m_current != currentWorkspace) {
         m_current = currentWorkspace;
@@ -246,35 +245,23 @@ bool WorkspacesInfo::changeCurrent(int newWorkspace)
 
 /* Helper function to read the value of an X11 window property of integer type of the
    length specified by by length and with name specified by property.
-   Please notice that you have to free the returned value with XFree in case of
-   success. */
-unsigned long * WorkspacesInfo::getX11IntProperty(Atom property, long length)
+   Returns an empty vector if the property is not set. Values are cached by
+   X11Properties until the property changes. */
+QVector<ulong> WorkspacesInfo::getX11IntProperty(Atom property, long length)
 {
-    Atom type_ret;
-    int format_ret;
-    unsigned long nitems_ret;
-    unsigned long bytes_after_ret;
-    unsigned char *value_ret;
-    int result;
-
-    result = XGetWindowProperty(QX11Info::display(), QX11Info::appRootWindow(),
-                                property,
-                                0, length, False, XA_CARDINAL,
-                                &type_ret, &format_ret, &nitems_ret,
-                                &bytes_after_ret, &value_ret);
-    if (result == Success) {
-        if (type_ret != None) {
-            return (unsigned long *) value_ret;
-        }
+    QVector<ulong> values = X11Properties::instance()->property(QX11Info::appRootWindow(),
+                                                                property, XA_CARDINAL).toULongs();
+    if (values.size() > length) {
+        values.resize(length);
     }
-
-    return NULL;
+    return values;
 }
 
 /* Helper function to write the value of X11 window property of integer type of
    the length specified. */
 void WorkspacesInfo::setX11IntProperty(Atom property, unsigned char *data, long length)
 {
+    X11Properties::instance()->invalidate(QX11Info::appRootWindow(), property);
     XChangeProperty(QX11Info::display(), QX11Info::appRootWindow(),
                     property,
                     XA_CARDINAL, 32,
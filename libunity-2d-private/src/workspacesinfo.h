@@ -2,6 +2,7 @@
 #define WORKSPACESINFO_H
 
 #include <QObject>
+#include <QVector>
 
 typedef unsigned long Atom;
 
@@ -59,7 +60,7 @@ private:
     void setWorkspaceLayoutToX(Orientation orientation, int columns, int rows, Corner startingCorner);
     void updateWorkspaceGeometryProperties(int workspaceCount, Orientation orientation, int columns, int rows, Corner startingCorner);
     void updateCurrentWorkspace();
-    unsigned long * getX11IntProperty(Atom property, long length);
+    QVector<ulong> getX11IntProperty(Atom property, long length);
     void setX11IntProperty(Atom property, unsigned char *data, long length);
 
 private:
@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2012 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Special ordering to bypass evil X11 include
+#include <QAbstractEventDispatcher>
+#include <QDebug>
+#include <QWidget>
+#include <QX11Info>
+
+// Self
+#include "x11properties.h"
+
+// Local
+#include <debug_p.h>
+#include <unity2dmetrics.h>
+
+// X11
+#include <X11/Xlib-xcb.h>
+#include <xcb/xcb.h>
+
+// libc
+#include <stdlib.h>
+
+/* Atoms used across unity-2d, interned together at startup */
+static const char* KNOWN_ATOMS[] = {
+    "_METACITY_WINDOW_CAPTURE",
+    "_NET_ACTIVE_WINDOW",
+    "_NET_CURRENT_DESKTOP",
+    "_NET_DESKTOP_LAYOUT",
+    "_NET_NUMBER_OF_DESKTOPS",
+    "_NET_WM_MOVERESIZE",
+    "_NET_WM_STATE",
+    "_NET_WM_STATE_SKIP_PAGER",
+    "_NET_WM_STATE_SKIP_TASKBAR",
+    "_NET_WM_STRUT_PARTIAL",
+};
+
+/* In 32 bit units, large enough for any property we care about */
+static const uint32_t MAX_PROPERTY_LENGTH = 0x1fffffff;
+
+QVector<ulong> X11Properties::Property::toULongs() const
+{
+    QVector<ulong> values;
+    if (format != 32) {
+        return values;
+    }
+    /* XCB, unlike Xlib, returns format 32 items as 32 bit integers */
+    const quint32* items = reinterpret_cast<const quint32*>(data.constData());
+    const int count = data.size() / sizeof(quint32);
+    values.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        values.append(items[i]);
+    }
+    return values;
+}
+
+X11Properties* X11Properties::instance()
+{
+    static X11Properties* properties = new X11Properties();
+    return properties;
+}
+
+X11Properties::X11Properties()
+: m_display(QX11Info::display())
+, m_cacheEnabled(false)
+{
+    const int count = sizeof(KNOWN_ATOMS) / sizeof(KNOWN_ATOMS[0]);
+    Atom atoms[count];
+    if (XInternAtoms(m_display, const_cast<char**>(KNOWN_ATOMS), count, False, atoms)) {
+        for (int i = 0; i < count; ++i) {
+            m_atoms.insert(KNOWN_ATOMS[i], atoms[i]);
+        }
+    }
+
+    Unity2dApplication* application = Unity2dApplication::instance();
+    if (application == NULL) {
+        /* This can happen for example when using qmlviewer to run the launcher */
+        UQ_DEBUG << "The application is not an Unity2dApplication."
+                    "X11 properties will not be cached.";
+    } else {
+        application->installX11EventFilter(this);
+        m_cacheEnabled = true;
+    }
+
+    connect(QAbstractEventDispatcher::instance(), SIGNAL(awake()), SLOT(processReplies()));
+}
+
+X11Properties::~X11Properties()
+{
+    xcb_connection_t* connection = XGetXCBConnection(m_display);
+    Q_FOREACH(const PendingRequest& request, m_pending) {
+        xcb_discard_reply(connection, request.sequence);
+    }
+}
+
+Atom X11Properties::atom(const char* name)
+{
+    QHash<QByteArray, Atom>::const_iterator it = m_atoms.constFind(name);
+    if (it != m_atoms.constEnd()) {
+        return it.value();
+    }
+    Atom atom = XInternAtom(m_display, name, False);
+    m_atoms.insert(name, atom);
+    return atom;
+}
+
+void X11Properties::prefetch(Window window, Atom property, Atom type)
+{
+    const Key key(window, property);
+    if (m_cache.contains(key) || m_pending.contains(key)) {
+        return;
+    }
+    watchWindow(window);
+    m_pending.insert(key, sendRequest(window, property, type));
+    xcb_flush(XGetXCBConnection(m_display));
+}
+
+X11Properties::Property X11Properties::property(Window window, Atom property, Atom type)
+{
+    const Key key(window, property);
+
+    Property value;
+    QHash<Key, Property>::const_iterator it = m_cache.constFind(key);
+    if (it != m_cache.constEnd()) {
+        value = it.value();
+    } else {
+        watchWindow(window);
+        PendingRequest request = m_pending.contains(key)
+            ? m_pending.take(key)
+            : sendRequest(window, property, type);
+
+        xcb_connection_t* connection = XGetXCBConnection(m_display);
+        xcb_get_property_cookie_t cookie;
+        cookie.sequence = request.sequence;
+        UQ_METRIC_COUNT("x11.roundtrips");
+        xcb_get_property_reply_t* reply = xcb_get_property_reply(connection, cookie, NULL);
+        value = readReply(reply);
+        free(reply);
+
+        if (request.type == AnyPropertyType || request.type == value.type) {
+            storeProperty(key, value);
+        }
+    }
+
+    if (type != AnyPropertyType && value.type != type) {
+        return Property();
+    }
+    return value;
+}
+
+void X11Properties::invalidate(Window window, Atom property)
+{
+    const Key key(window, property);
+    m_cache.remove(key);
+    if (m_pending.contains(key)) {
+        /* The reply may predate the change */
+        PendingRequest request = m_pending.take(key);
+        xcb_discard_reply(XGetXCBConnection(m_display), request.sequence);
+    }
+}
+
+bool X11Properties::x11EventFilter(XEvent* event)
+{
+    if (event->type == PropertyNotify) {
+        XPropertyEvent* notify = (XPropertyEvent*) event;
+        invalidate(notify->window, notify->atom);
+    } else if (event->type == DestroyNotify) {
+        const Window window = event->xdestroywindow.window;
+        if (m_watchedWindows.remove(window)) {
+            QHash<Key, Property>::iterator it = m_cache.begin();
+            while (it != m_cache.end()) {
+                if (it.key().first == window) {
+                    it = m_cache.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+    }
+    /* We only monitor events */
+    return false;
+}
+
+void X11Properties::processReplies()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    xcb_connection_t* connection = XGetXCBConnection(m_display);
+    QHash<Key, PendingRequest>::iterator it = m_pending.begin();
+    while (it != m_pending.end()) {
+        void* reply = 0;
+        xcb_generic_error_t* error = 0;
+        if (!xcb_poll_for_reply(connection, it.value().sequence, &reply, &error)) {
+            ++it;
+            continue;
+        }
+        if (reply != 0) {
+            const Property value = readReply(reply);
+            if (it.value().type == AnyPropertyType || it.value().type == value.type) {
+                storeProperty(it.key(), value);
+            }
+            free(reply);
+        }
+        free(error);
+        it = m_pending.erase(it);
+    }
+}
+
+void X11Properties::watchWindow(Window window)
+{
+    if (!m_cacheEnabled || m_watchedWindows.contains(window)) {
+        return;
+    }
+    m_watchedWindows.insert(window);
+
+    /* Qt already listens to property changes on its own windows */
+    if (QWidget::find(window) != 0) {
+        return;
+    }
+
+    /* Do not override the events other parts of unity-2d selected */
+    XWindowAttributes attributes;
+    UQ_METRIC_COUNT("x11.roundtrips");
+    if (!XGetWindowAttributes(m_display, window, &attributes)) {
+        return;
+    }
+    long mask = attributes.your_event_mask | PropertyChangeMask;
+    if (window != QX11Info::appRootWindow()) {
+        mask |= StructureNotifyMask;
+    }
+    if (mask != attributes.your_event_mask) {
+        XSelectInput(m_display, window, mask);
+    }
+}
+
+X11Properties::PendingRequest X11Properties::sendRequest(Window window, Atom property, Atom type)
+{
+    xcb_get_property_cookie_t cookie = xcb_get_property(XGetXCBConnection(m_display),
+        0, window, property, type, 0, MAX_PROPERTY_LENGTH);
+
+    PendingRequest request;
+    request.sequence = cookie.sequence;
+    request.type = type;
+    return request;
+}
+
+X11Properties::Property X11Properties::readReply(void* data)
+{
+    Property value;
+    xcb_get_property_reply_t* reply = static_cast<xcb_get_property_reply_t*>(data);
+    if (reply == 0) {
+        return value;
+    }
+    value.type = reply->type;
+    value.format = reply->format;
+    value.data = QByteArray(static_cast<const char*>(xcb_get_property_value(reply)),
+                            xcb_get_property_value_length(reply));
+    return value;
+}
+
+void X11Properties::storeProperty(const Key& key, const Property& value)
+{
+    if (m_cacheEnabled) {
+        m_cache.insert(key, value);
+    }
+}
+
+#include "x11properties.moc"
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2012 Canonical, Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef X11PROPERTIES_H
+#define X11PROPERTIES_H
+
+// Qt
+#include <QByteArray>
+#include <QHash>
+#include <QObject>
+#include <QPair>
+#include <QSet>
+#include <QVector>
+
+// libunity-2d
+#include "unity2dapplication.h"
+
+// X11
+#include <X11/Xlib.h>
+
+/**
+ * Shared access to X11 atoms and window properties of Qt's X connection.
+ *
+ * The atoms commonly used by unity-2d are interned in a single request when
+ * the instance is created, other atoms are interned once on first use.
+ *
+ * Properties are read through XCB so that requests can be sent ahead of time
+ * with prefetch() without blocking the GUI thread. Replies are cached per
+ * window and the cache is invalidated when PropertyNotify is received, so
+ * reading an unchanged property again costs no round-trip. Caching is only
+ * enabled when running in a Unity2dApplication, as we need its event filter
+ * to receive PropertyNotify.
+ *
+ * Selecting PropertyNotify on a window which is not ours the first time one
+ * of its properties is read takes a synchronous XGetWindowAttributes.
+ *
+ * This class must only be used from the GUI thread.
+ */
+class X11Properties : public QObject, protected AbstractX11EventFilter
+{
+    Q_OBJECT
+
+public:
+    struct Property
+    {
+        Property() : type(None), format(0) {}
+
+        bool isValid() const { return type != None; }
+
+        /**
+         * Returns the content of a format 32 property
+         */
+        QVector<ulong> toULongs() const;
+
+        Atom type;
+        int format;
+        QByteArray data;
+    };
+
+    static X11Properties* instance();
+    ~X11Properties();
+
+    /**
+     * Returns the atom named @p name, interning it if needed
+     */
+    Atom atom(const char* name);
+
+    /**
+     * Sends a request to read @p property of @p window without waiting for
+     * the reply, which is then cached as soon as it arrives.
+     */
+    void prefetch(Window window, Atom property, Atom type = AnyPropertyType);
+
+    /**
+     * Returns @p property of @p window. The value comes from the cache if
+     * possible; if a prefetch() is in flight, this only waits for its reply.
+     * Otherwise this is a synchronous round-trip.
+     */
+    Property property(Window window, Atom property, Atom type = AnyPropertyType);
+
+    /**
+     * Drops the cached value of @p property. Use this when a property is
+     * changed and read again before the PropertyNotify is processed.
+     */
+    void invalidate(Window window, Atom property);
+
+protected:
+    bool x11EventFilter(XEvent* event);
+
+private Q_SLOTS:
+    void processReplies();
+
+private:
+    X11Properties();
+    Q_DISABLE_COPY(X11Properties)
+
+    typedef QPair<Window, Atom> Key;
+
+    struct PendingRequest
+    {
+        unsigned int sequence;
+        Atom type;
+    };
+
+    void watchWindow(Window window);
+    PendingRequest sendRequest(Window window, Atom property, Atom type);
+    Property readReply(void* reply);
+    void storeProperty(const Key& key, const Property& value);
+
+    Display* m_display;
+    bool m_cacheEnabled;
+    QHash<QByteArray, Atom> m_atoms;
+    QHash<Key, Property> m_cache;
+    QHash<Key, PendingRequest> m_pending;
+    QSet<Window> m_watchedWindows;
+};
+
+#endif // X11PROPERTIES_H
@@ -0,0 +1,209 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Local
+#include <adaptiveupdatemode.h>
+#include <unity2dmetrics.h>
+
+// Qt
+#include <QGraphicsScene>
+#include <QtTest>
+
+// libc
+#include <unistd.h>
+
+/* A view of another class, as the spread is next to the shell */
+class OtherView : public QGraphicsView
+{
+    Q_OBJECT
+public:
+    OtherView(QGraphicsScene* scene) : QGraphicsView(scene) {}
+};
+
+static int modeGauge(const char* name)
+{
+    return Unity2dMetrics::instance()->gauges().value(name, -1).toInt();
+}
+
+static void paintFrame(AdaptiveUpdateMode* mode, const QRegion& region, int microseconds)
+{
+    mode->beginFrame();
+    usleep(microseconds);
+    mode->endFrame(region);
+}
+
+/* 10x10 squares of a 200x200 checkerboard at @p origin: many small
+   rectangles that QRegion cannot merge, half of their bounding rectangle */
+static QRegion checkerboard(const QPoint& origin)
+{
+    QRegion region;
+    for (int row = 0; row < 20; ++row) {
+        for (int column = row % 2; column < 20; column += 2) {
+            region += QRect(origin.x() + column * 10, origin.y() + row * 10, 10, 10);
+        }
+    }
+    return region;
+}
+
+class AdaptiveUpdateModeTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testDisabled()
+    {
+        QGraphicsScene scene;
+        QGraphicsView view(&scene);
+        view.setViewportUpdateMode(QGraphicsView::SmartViewportUpdate);
+        AdaptiveUpdateMode mode(&view);
+        QVERIFY(!mode.isEnabled());
+        for (int i = 0; i < 10; ++i) {
+            paintFrame(&mode, QRegion(0, 0, 10, 10), 0);
+        }
+        QCOMPARE(view.viewportUpdateMode(), QGraphicsView::SmartViewportUpdate);
+
+        mode.setEnabled(true);
+        QCOMPARE(view.viewportUpdateMode(), QGraphicsView::MinimalViewportUpdate);
+    }
+
+    void testSparseRegionStaysMinimal()
+    {
+        QGraphicsScene scene;
+        QGraphicsView view(&scene);
+        view.resize(1000, 1000);
+        AdaptiveUpdateMode mode(&view);
+        mode.setEnabled(true);
+
+        /* A blinking cursor and a spinner in opposite corners: their bounding
+           rectangle is the whole view */
+        QRegion region = QRegion(0, 0, 10, 10) + QRegion(900, 900, 20, 20);
+        for (int i = 0; i < 20; ++i) {
+            paintFrame(&mode, region, 1000);
+        }
+        QCOMPARE(mode.mode(), QGraphicsView::MinimalViewportUpdate);
+    }
+
+    void testDenseRegionSwitchesToBoundingRect()
+    {
+        QGraphicsScene scene;
+        QGraphicsView view(&scene);
+        view.resize(1000, 1000);
+        /* Sends the pending resize, which lays the viewport out */
+        view.show();
+        AdaptiveUpdateMode mode(&view);
+        mode.setEnabled(true);
+
+        /* Cheap frames: the cost of the 200 rectangles outweighs the pixels */
+        const QRegion region = checkerboard(QPoint(100, 100));
+        QCOMPARE(region.rects().count(), 200);
+        for (int i = 0; i < 4; ++i) {
+            paintFrame(&mode, region, 0);
+        }
+        QCOMPARE(mode.mode(), QGraphicsView::MinimalViewportUpdate);
+
+        paintFrame(&mode, region, 0);
+        QCOMPARE(mode.mode(), QGraphicsView::BoundingRectViewportUpdate);
+        QCOMPARE(view.viewportUpdateMode(), QGraphicsView::BoundingRectViewportUpdate);
+    }
+
+    void testModeIsReportedPerView()
+    {
+        QGraphicsScene scene;
+        QGraphicsView view(&scene);
+        view.resize(1000, 1000);
+        view.show();
+        AdaptiveUpdateMode mode(&view);
+        mode.setEnabled(true);
+
+        OtherView otherView(&scene);
+        otherView.resize(1000, 1000);
+        otherView.show();
+        AdaptiveUpdateMode otherMode(&otherView);
+        otherMode.setEnabled(true);
+
+        const QRegion region = checkerboard(QPoint(100, 100));
+        for (int i = 0; i < 5; ++i) {
+            paintFrame(&mode, region, 0);
+        }
+        paintFrame(&otherMode, QRegion(0, 0, 10, 10), 0);
+
+        QCOMPARE(modeGauge("viewport.update_mode.QGraphicsView.0"),
+                 int(QGraphicsView::BoundingRectViewportUpdate));
+        QCOMPARE(modeGauge("viewport.update_mode.OtherView.0"),
+                 int(QGraphicsView::MinimalViewportUpdate));
+    }
+
+    void testDenseRegionCoveringViewSwitchesToFull()
+    {
+        QGraphicsScene scene;
+        QGraphicsView view(&scene);
+        view.resize(200, 200);
+        view.show();
+        AdaptiveUpdateMode mode(&view);
+        mode.setEnabled(true);
+
+        const QRegion region = checkerboard(QPoint(0, 0));
+        for (int i = 0; i < 5; ++i) {
+            paintFrame(&mode, region, 0);
+        }
+        QCOMPARE(mode.mode(), QGraphicsView::FullViewportUpdate);
+    }
+
+    void testProbesMinimalAgain()
+    {
+        QGraphicsScene scene;
+        QGraphicsView view(&scene);
+        view.resize(1000, 1000);
+        view.show();
+        AdaptiveUpdateMode mode(&view);
+        mode.setEnabled(true);
+
+        const QRegion region = checkerboard(QPoint(100, 100));
+        for (int i = 0; i < 5; ++i) {
+            paintFrame(&mode, region, 0);
+        }
+        QCOMPARE(mode.mode(), QGraphicsView::BoundingRectViewportUpdate);
+
+        /* PROBE_INTERVAL frames later, minimal updates are tried again */
+        for (int i = 0; i < 119; ++i) {
+            paintFrame(&mode, region, 0);
+        }
+        QCOMPARE(mode.mode(), QGraphicsView::BoundingRectViewportUpdate);
+        paintFrame(&mode, region, 0);
+        QCOMPARE(mode.mode(), QGraphicsView::MinimalViewportUpdate);
+        QCOMPARE(view.viewportUpdateMode(), QGraphicsView::MinimalViewportUpdate);
+    }
+
+    void testOverrideIsRespected()
+    {
+        QGraphicsScene scene;
+        QGraphicsView view(&scene);
+        AdaptiveUpdateMode mode(&view);
+        mode.setEnabled(true);
+
+        view.setViewportUpdateMode(QGraphicsView::FullViewportUpdate);
+        for (int i = 0; i < 200; ++i) {
+            paintFrame(&mode, QRegion(0, 0, 10, 10), 0);
+        }
+        QCOMPARE(view.viewportUpdateMode(), QGraphicsView::FullViewportUpdate);
+    }
+};
+
+QTEST_MAIN(AdaptiveUpdateModeTest)
+
+#include "adaptiveupdatemodetest.moc"
@@ -0,0 +1,153 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Local
+#include <unitytesthelpers.h>
+#include <desktopentryindex.h>
+
+// Qt
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QtTest>
+
+// GIO
+#include <gio/gdesktopappinfo.h>
+
+// libc
+#include <stdlib.h>
+
+static void writeDesktopFile(const QString& path, const QString& name)
+{
+    QDir().mkpath(QFileInfo(path).path());
+    QFile file(path);
+    file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    file.write("[Desktop Entry]\nType=Application\nExec=true\nName=");
+    file.write(name.toUtf8());
+    file.write("\n");
+}
+
+static QString appInfoName(const QString& path)
+{
+    GDesktopAppInfo* info = DesktopEntryIndex::instance()->appInfo(path);
+    if (info == NULL) {
+        return QString();
+    }
+    const QString name = QString::fromUtf8(g_app_info_get_name(G_APP_INFO(info)));
+    g_object_unref(info);
+    return name;
+}
+
+class DesktopEntryIndexTest : public QObject
+{
+    Q_OBJECT
+    UnityTest::TemporaryDir m_root;
+    QString m_homeDir;
+    QString m_systemDir;
+
+public:
+    DesktopEntryIndexTest()
+    : m_root("desktopentryindextest")
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        g_type_init();
+
+        m_homeDir = m_root.path() + "/home/applications";
+        m_systemDir = m_root.path() + "/system/applications";
+        writeDesktopFile(m_systemDir + "/plain.desktop", "Plain");
+        writeDesktopFile(m_systemDir + "/wine/Programs/Foo/bar.desktop", "Bar");
+        writeDesktopFile(m_systemDir + "/shadowed.desktop", "System");
+        writeDesktopFile(m_homeDir + "/shadowed.desktop", "Home");
+
+        // Must be set before the index gets created
+        setenv("XDG_DATA_HOME", QFile::encodeName(m_root.path() + "/home").constData(), 1);
+        setenv("XDG_DATA_DIRS", QFile::encodeName(m_root.path() + "/system").constData(), 1);
+        DesktopEntryIndex* index = DesktopEntryIndex::instance();
+        QCOMPARE(index->scanCount(), 1);
+
+        // The first scan runs in the background
+        QVERIFY(index->path("plain.desktop").isEmpty());
+        QSignalSpy spy(index, SIGNAL(changed()));
+        for (int i = 0; i < 20 && spy.isEmpty(); ++i) {
+            QTest::qWait(100);
+        }
+        QCOMPARE(spy.count(), 1);
+    }
+
+    void testNestedId()
+    {
+        DesktopEntryIndex* index = DesktopEntryIndex::instance();
+        const QString path = m_systemDir + "/wine/Programs/Foo/bar.desktop";
+        QCOMPARE(index->path("plain.desktop"), m_systemDir + "/plain.desktop");
+        QCOMPARE(index->path("wine-Programs-Foo-bar.desktop"), path);
+        QCOMPARE(index->desktopId(path), QString("wine-Programs-Foo-bar.desktop"));
+        QVERIFY(index->path("missing.desktop").isEmpty());
+    }
+
+    void testPrecedence()
+    {
+        DesktopEntryIndex* index = DesktopEntryIndex::instance();
+        QCOMPARE(index->path("shadowed.desktop"), m_homeDir + "/shadowed.desktop");
+        QVERIFY(index->desktopId(m_systemDir + "/shadowed.desktop").isEmpty());
+    }
+
+    void testParsedEntriesAreShared()
+    {
+        DesktopEntryIndex* index = DesktopEntryIndex::instance();
+        const QString path = m_systemDir + "/plain.desktop";
+        const int parseCount = index->parseCount();
+
+        QCOMPARE(appInfoName(path), QString("Plain"));
+        QCOMPARE(appInfoName(path), QString("Plain"));
+        QCOMPARE(index->parseCount(), parseCount + 1);
+
+        // Modifying the file makes it parsed again
+        writeDesktopFile(path, "Plain modified");
+        QCOMPARE(appInfoName(path), QString("Plain modified"));
+        QCOMPARE(index->parseCount(), parseCount + 2);
+    }
+
+    void testInstalledEntry()
+    {
+        DesktopEntryIndex* index = DesktopEntryIndex::instance();
+        QSignalSpy spy(index, SIGNAL(changed()));
+
+        writeDesktopFile(m_systemDir + "/new/app.desktop", "New");
+        for (int i = 0; i < 20 && spy.isEmpty(); ++i) {
+            QTest::qWait(100);
+        }
+        QCOMPARE(spy.count(), 1);
+        QCOMPARE(index->path("new-app.desktop"), m_systemDir + "/new/app.desktop");
+
+        QFile::remove(m_systemDir + "/new/app.desktop");
+        for (int i = 0; i < 20 && spy.count() < 2; ++i) {
+            QTest::qWait(100);
+        }
+        QCOMPARE(spy.count(), 2);
+        QVERIFY(index->path("new-app.desktop").isEmpty());
+    }
+};
+
+QTEST_MAIN(DesktopEntryIndexTest)
+
+#include "desktopentryindextest.moc"
@@ -0,0 +1,77 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Local
+#include <frameprofiler.h>
+#include <unity2dmetrics.h>
+
+// Qt
+#include <QGraphicsScene>
+#include <QGraphicsView>
+#include <QtTest>
+
+static qint64 histogramCount(const char* name)
+{
+    return Unity2dMetrics::instance()->histograms().value(name).toMap().value("count").toLongLong();
+}
+
+class FrameProfilerTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testParseFlags()
+    {
+        QCOMPARE(FrameProfiler::parseFlags(QString()), FrameProfiler::Flags());
+        QCOMPARE(FrameProfiler::parseFlags("1"), FrameProfiler::Flags(FrameProfiler::Frames));
+        QCOMPARE(FrameProfiler::parseFlags("items,overlay"),
+                 FrameProfiler::Frames | FrameProfiler::Items | FrameProfiler::Overlay);
+    }
+
+    void testFrames()
+    {
+        QGraphicsScene scene;
+        QGraphicsView view(&scene);
+        view.resize(100, 100);
+        FrameProfiler profiler(&view);
+
+        FrameProfiler::setFlags(FrameProfiler::Flags());
+        profiler.beginFrame(QRegion(0, 0, 100, 100));
+        profiler.endFrame();
+        QCOMPARE(histogramCount("frame.paint"), qint64(0));
+
+        FrameProfiler::setFlags(FrameProfiler::Frames);
+        profiler.beginFrame(QRegion(0, 0, 50, 20));
+        profiler.endFrame();
+        profiler.beginFrame(QRegion(0, 0, 50, 20));
+        profiler.endFrame();
+        QCOMPARE(histogramCount("frame.paint"), qint64(2));
+        QCOMPARE(histogramCount("frame.interval"), qint64(1));
+        QCOMPARE(histogramCount("frame.dirty_area"), qint64(2));
+        QVERIFY(!view.optimizationFlags().testFlag(QGraphicsView::IndirectPainting));
+
+        FrameProfiler::setFlags(FrameProfiler::Frames | FrameProfiler::Items);
+        QVERIFY(profiler.profilesItems());
+        QVERIFY(view.optimizationFlags().testFlag(QGraphicsView::IndirectPainting));
+        FrameProfiler::setFlags(FrameProfiler::Flags());
+    }
+};
+
+QTEST_MAIN(FrameProfilerTest)
+
+#include "frameprofilertest.moc"
@@ -0,0 +1,184 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Local
+#include <unitytesthelpers.h>
+#include <gestureinterpreter.h>
+
+// Qt
+#include <QSignalSpy>
+#include <QtTest>
+
+/* A gesture event as recorded from GEIS */
+struct GestureTraceEvent
+{
+    GestureEvent::Phase phase;
+    GestureEvent::Type type;
+    int timestamp;
+    float radius;
+    float radiusDelta;
+    float deltaX;
+};
+
+/* Pinching inwards then, after a pause, outwards */
+static const GestureTraceEvent pinchTrace[] = {
+    { GestureEvent::Start,  GestureEvent::Pinch3,    0, 200, -5, 0 },
+    { GestureEvent::Update, GestureEvent::Pinch3,   20, 180, -20, 0 },
+    { GestureEvent::Update, GestureEvent::Pinch3,   40, 150, -30, 0 },
+    { GestureEvent::Update, GestureEvent::Pinch3,  600, 155, 5, 0 },
+    { GestureEvent::Update, GestureEvent::Pinch3, 1200, 200, 45, 0 },
+    { GestureEvent::Finish, GestureEvent::Pinch3, 1220, 200, 0, 0 },
+};
+
+/* A 4 fingers drag */
+static const GestureTraceEvent dragTrace[] = {
+    { GestureEvent::Start,  GestureEvent::Drag4,  0, 0, 0, 10 },
+    { GestureEvent::Update, GestureEvent::Drag4,  5, 0, 0, 4 },
+    { GestureEvent::Update, GestureEvent::Drag4, 10, 0, 0, 6 },
+    { GestureEvent::Update, GestureEvent::Drag4, 15, 0, 0, -2 },
+    { GestureEvent::Finish, GestureEvent::Drag4, 20, 0, 0, 2 },
+};
+
+/* A 4 fingers tap */
+static const GestureTraceEvent tapTrace[] = {
+    { GestureEvent::Start,  GestureEvent::Tap4, 0, 0, 0, 0 },
+    { GestureEvent::Update, GestureEvent::Tap4, 0, 0, 0, 0 },
+    { GestureEvent::Finish, GestureEvent::Tap4, 0, 0, 0, 0 },
+};
+
+struct GestureReplayer
+{
+    GestureInterpreter *interpreter;
+
+    void operator()(const GestureTraceEvent &traceEvent, int) const
+    {
+        GestureEvent event;
+        event.phase = traceEvent.phase;
+        event.type = traceEvent.type;
+        event.timestamp = traceEvent.timestamp;
+        event.radius = traceEvent.radius;
+        event.radiusDelta = traceEvent.radiusDelta;
+        event.deltaX = traceEvent.deltaX;
+        interpreter->processEvent(event);
+    }
+};
+
+static void replayTrace(GestureInterpreter *interpreter, const GestureTraceEvent *trace, int count)
+{
+    GestureReplayer replayer = { interpreter };
+    UnityTest::replayTrace(trace, count, replayer);
+}
+
+class GestureInterpreterTest : public QObject
+{
+    Q_OBJECT
+private Q_SLOTS:
+    void testPinch()
+    {
+        GestureInterpreter interpreter;
+        QSignalSpy zoomInSpy(&interpreter, SIGNAL(spreadZoomInRequested()));
+        QSignalSpy zoomOutSpy(&interpreter, SIGNAL(spreadZoomOutRequested()));
+
+        // Starting inwards zooms out right away
+        replayTrace(&interpreter, pinchTrace, 1);
+        QCOMPARE(zoomOutSpy.count(), 1);
+        QCOMPARE(zoomInSpy.count(), 0);
+        QCOMPARE(interpreter.state(), GestureInterpreter::Pinching);
+
+        // Continuing the same pinch does not trigger anything else
+        replayTrace(&interpreter, pinchTrace + 1, 2);
+        QCOMPARE(zoomOutSpy.count(), 1);
+        QCOMPARE(zoomInSpy.count(), 0);
+
+        // Small movements after a pause are ignored
+        replayTrace(&interpreter, pinchTrace + 3, 1);
+        QCOMPARE(zoomOutSpy.count(), 1);
+        QCOMPARE(zoomInSpy.count(), 0);
+
+        // Spreading the fingers enough zooms back in
+        replayTrace(&interpreter, pinchTrace + 4, 2);
+        QCOMPARE(zoomOutSpy.count(), 1);
+        QCOMPARE(zoomInSpy.count(), 1);
+        QCOMPARE(interpreter.state(), GestureInterpreter::Idle);
+    }
+
+    void testDrag()
+    {
+        GestureInterpreter interpreter;
+        QSignalSpy startedSpy(&interpreter, SIGNAL(dragStarted()));
+        QSignalSpy finishedSpy(&interpreter, SIGNAL(dragFinished()));
+
+        replayTrace(&interpreter, dragTrace, 1);
+        QCOMPARE(startedSpy.count(), 1);
+        QCOMPARE(interpreter.state(), GestureInterpreter::Dragging);
+        QCOMPARE(interpreter.dragDelta(), 10.f);
+
+        replayTrace(&interpreter, dragTrace + 1, 3);
+        QCOMPARE(interpreter.dragDelta(), 18.f);
+        QCOMPARE(finishedSpy.count(), 0);
+
+        replayTrace(&interpreter, dragTrace + 4, 1);
+        QCOMPARE(interpreter.dragDelta(), 20.f);
+        QCOMPARE(finishedSpy.count(), 1);
+        QCOMPARE(interpreter.state(), GestureInterpreter::Idle);
+    }
+
+    void testPinchFinishDuringDrag()
+    {
+        GestureInterpreter interpreter;
+
+        replayTrace(&interpreter, dragTrace, 1);
+        QCOMPARE(interpreter.state(), GestureInterpreter::Dragging);
+
+        // The end of a pinch does not interrupt the drag
+        replayTrace(&interpreter, pinchTrace + 5, 1);
+        QCOMPARE(interpreter.state(), GestureInterpreter::Dragging);
+    }
+
+    void testPinchStartDuringDrag()
+    {
+        GestureInterpreter interpreter;
+
+        replayTrace(&interpreter, dragTrace, 1);
+
+        // A pinch starting during the drag does not interrupt it
+        replayTrace(&interpreter, pinchTrace, 3);
+        QCOMPARE(interpreter.state(), GestureInterpreter::Dragging);
+
+        // Once the drag is over the pinch is still tracked
+        replayTrace(&interpreter, dragTrace + 4, 1);
+        QCOMPARE(interpreter.state(), GestureInterpreter::Pinching);
+
+        replayTrace(&interpreter, pinchTrace + 5, 1);
+        QCOMPARE(interpreter.state(), GestureInterpreter::Idle);
+    }
+
+    void testTap()
+    {
+        GestureInterpreter interpreter;
+        QSignalSpy toggleSpy(&interpreter, SIGNAL(toggleDashRequested()));
+
+        replayTrace(&interpreter, tapTrace, TRACE_LENGTH(tapTrace));
+        QCOMPARE(toggleSpy.count(), 1);
+        QCOMPARE(interpreter.state(), GestureInterpreter::Idle);
+    }
+};
+
+QTEST_MAIN(GestureInterpreterTest)
+
+#include "gestureinterpretertest.moc"
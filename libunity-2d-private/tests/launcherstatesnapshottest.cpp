@@ -0,0 +1,93 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Local
+#include <unitytesthelpers.h>
+#include <launcherstatesnapshot.h>
+
+// Qt
+#include <QFile>
+#include <QtTest>
+
+// libc
+#include <stdlib.h>
+
+class LauncherStateSnapshotTest : public QObject
+{
+    Q_OBJECT
+    UnityTest::TemporaryDir m_cacheDir;
+
+public:
+    LauncherStateSnapshotTest()
+    : m_cacheDir("launcherstatesnapshottest")
+    {
+    }
+
+private Q_SLOTS:
+    void initTestCase()
+    {
+        setenv("XDG_CACHE_HOME", QFile::encodeName(m_cacheDir.path()).constData(), 1);
+    }
+
+    void testMissing()
+    {
+        QFile::remove(LauncherStateSnapshot::fileName());
+        LauncherStateSnapshot snapshot;
+        QVERIFY(!snapshot.load());
+    }
+
+    void testRoundTrip()
+    {
+        LauncherStateSnapshot::Entry entry;
+        entry.desktopFile = "/usr/share/applications/firefox.desktop";
+        entry.name = QString::fromUtf8("Firefox Web Browser");
+        entry.icon = "firefox";
+        entry.executable = "firefox";
+
+        LauncherStateSnapshot snapshot;
+        snapshot.setFavorites(QStringList() << "firefox.desktop");
+        snapshot.setEntries(QList<LauncherStateSnapshot::Entry>() << entry);
+        QVERIFY(snapshot.save());
+
+        LauncherStateSnapshot loaded;
+        QVERIFY(loaded.load());
+        QCOMPARE(loaded.favorites(), QStringList() << "firefox.desktop");
+        QCOMPARE(loaded.entries().count(), 1);
+        QCOMPARE(loaded.entries().at(0).desktopFile, entry.desktopFile);
+        QCOMPARE(loaded.entries().at(0).name, entry.name);
+        QCOMPARE(loaded.entries().at(0).icon, entry.icon);
+        QCOMPARE(loaded.entries().at(0).executable, entry.executable);
+    }
+
+    void testUnknownVersion()
+    {
+        QFile file(LauncherStateSnapshot::fileName());
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        QDataStream stream(&file);
+        stream << quint32(0x55324c53) << quint32(0xffff);
+        file.close();
+
+        LauncherStateSnapshot snapshot;
+        QVERIFY(!snapshot.load());
+        QVERIFY(snapshot.entries().isEmpty());
+    }
+};
+
+QTEST_MAIN(LauncherStateSnapshotTest)
+
+#include "launcherstatesnapshottest.moc"
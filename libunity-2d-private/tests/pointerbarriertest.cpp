@@ -21,7 +21,9 @@
 
 // Local
 #include <unitytestmacro.h>
+#include <unitytesthelpers.h>
 #include <pointerbarrier.h>
+#include <pointerbarriermanager.h>
 
 // Qt
 #include <QApplication>
@@ -51,10 +53,200 @@ private:
     PointerBarrierWrapper *m_barrier;
 };
 
+/* A barrier hit as recorded from XFixesBarrierNotifyEvent. Time is in
+   milliseconds, relative to the beginning of the trace. */
+struct BarrierTraceEvent
+{
+    quint32 time;
+    int x;
+    int y;
+    int velocity;
+};
+
+/* Pushing against the barrier at x=100 ten times per second */
+static const BarrierTraceEvent slowPushTrace[] = {
+    {   0, 99, 50, 1000 },
+    { 100, 99, 50, 1000 },
+    { 200, 99, 50, 1000 },
+    { 300, 99, 50, 1000 },
+};
+
+/* Same pushes with long pauses in between: pressure decays before the next one */
+static const BarrierTraceEvent pausedPushTrace[] = {
+    {    0, 99, 50, 1000 },
+    { 2000, 99, 50, 1000 },
+    { 4000, 99, 50, 1000 },
+    { 6000, 99, 50, 1000 },
+    { 8000, 99, 50, 1000 },
+};
+
+/* A 125Hz mouse pushing steadily */
+static const BarrierTraceEvent fastPushTrace[] = {
+    {   0, 99, 50, 1000 },
+    {   8, 99, 50, 1000 },
+    {  16, 99, 50, 1000 },
+    {  24, 99, 50, 1000 },
+    {  32, 99, 50, 1000 },
+    {  40, 99, 50, 1000 },
+    {  48, 99, 50, 1000 },
+    {  56, 99, 50, 1000 },
+    {  64, 99, 50, 1000 },
+    {  72, 99, 50, 1000 },
+    {  80, 99, 50, 1000 },
+    {  88, 99, 50, 1000 },
+    {  96, 99, 50, 1000 },
+    { 104, 99, 50, 1000 },
+};
+
+/* A very fast flick, velocities exceed the maximum and must be clamped */
+static const BarrierTraceEvent flickTrace[] = {
+    {  0, 99, 50, 50000 },
+    { 10, 99, 50, 50000 },
+};
+
+struct BarrierReplayer
+{
+    PointerBarrierWrapper *barrier;
+    quint32 baseTime;
+
+    void operator()(const BarrierTraceEvent &traceEvent, int index) const
+    {
+        PointerBarrierEvent event;
+        event.x = traceEvent.x;
+        event.y = traceEvent.y;
+        event.velocity = traceEvent.velocity;
+        event.eventId = index + 1;
+        event.timestamp = baseTime + traceEvent.time;
+        QVERIFY(PointerBarrierManager::instance()->dispatchEvent(barrier->barrier(), event));
+    }
+};
+
+/* Feeds @count events of @trace to @barrier as if they came from the X
+   server, starting at server time @baseTime */
+static void replayTrace(PointerBarrierWrapper *barrier, const BarrierTraceEvent *trace, int count, quint32 baseTime = 1000)
+{
+    BarrierReplayer replayer = { barrier, baseTime };
+    UnityTest::replayTrace(trace, count, replayer);
+}
+
+static void setupReplayBarrier(PointerBarrierWrapper *barrier)
+{
+    barrier->setP1(QPointF(100, 0));
+    barrier->setP2(QPointF(100, 100));
+    barrier->setThreshold(6500);
+    barrier->setMaxVelocityMultiplier(2);
+    barrier->setDecayRate(1500);
+    barrier->setTriggerPressure(2000);
+    barrier->setBreakPressure(2000);
+}
+
 class PointerBarrierTest : public QObject
 {
     Q_OBJECT
 private Q_SLOTS:
+    void testReplayBreak()
+    {
+        PointerBarrierWrapper barrier;
+        setupReplayBarrier(&barrier);
+        QVERIFY(barrier.barrier() != 0);
+
+        QSignalSpy brokenSpy(&barrier, SIGNAL(broken()));
+        QSignalSpy triggeredSpy(&barrier, SIGNAL(triggered()));
+
+        // Pressure is evaluated as soon as events come in, no need to wait
+        replayTrace(&barrier, slowPushTrace, 2);
+        QCOMPARE(brokenSpy.count(), 0);
+
+        replayTrace(&barrier, slowPushTrace + 2, 1);
+        QCOMPARE(brokenSpy.count(), 1);
+        QCOMPARE(triggeredSpy.count(), 0);
+    }
+
+    void testReplayDecay()
+    {
+        PointerBarrierWrapper barrier;
+        setupReplayBarrier(&barrier);
+
+        QSignalSpy brokenSpy(&barrier, SIGNAL(broken()));
+
+        replayTrace(&barrier, pausedPushTrace, TRACE_LENGTH(pausedPushTrace));
+        QCOMPARE(brokenSpy.count(), 0);
+    }
+
+    void testReplayHighEventRate()
+    {
+        PointerBarrierWrapper barrier;
+        setupReplayBarrier(&barrier);
+
+        QSignalSpy brokenSpy(&barrier, SIGNAL(broken()));
+
+        // Frequent events must not add up to more pressure than the
+        // velocity they report
+        replayTrace(&barrier, fastPushTrace, 10);
+        QCOMPARE(brokenSpy.count(), 0);
+
+        replayTrace(&barrier, fastPushTrace + 10, TRACE_LENGTH(fastPushTrace) - 10);
+        QCOMPARE(brokenSpy.count(), 1);
+    }
+
+    void testReplayVelocityClamp()
+    {
+        PointerBarrierWrapper barrier;
+        setupReplayBarrier(&barrier);
+
+        QSignalSpy brokenSpy(&barrier, SIGNAL(broken()));
+
+        // The first event is clamped to 1200, the second one only stands
+        // for 10ms
+        replayTrace(&barrier, flickTrace, TRACE_LENGTH(flickTrace));
+        QCOMPARE(brokenSpy.count(), 0);
+    }
+
+    void testReplayTrigger()
+    {
+        PointerBarrierWrapper barrier;
+        setupReplayBarrier(&barrier);
+        barrier.setTriggerZoneP1(QPointF(100, 0));
+        barrier.setTriggerZoneP2(QPointF(100, 100));
+        barrier.setTriggerZoneEnabled(true);
+
+        QSignalSpy brokenSpy(&barrier, SIGNAL(broken()));
+        QSignalSpy triggeredSpy(&barrier, SIGNAL(triggered()));
+
+        replayTrace(&barrier, slowPushTrace, 3);
+        QCOMPARE(triggeredSpy.count(), 1);
+        QCOMPARE(brokenSpy.count(), 0);
+    }
+
+    void testReplayTriggerOnly()
+    {
+        PointerBarrierWrapper barrier;
+        setupReplayBarrier(&barrier);
+        barrier.setTriggerOnly(true);
+
+        QSignalSpy brokenSpy(&barrier, SIGNAL(broken()));
+
+        // Hits from the non triggering side release the pointer right away,
+        // but still add up to the break pressure
+        replayTrace(&barrier, slowPushTrace, 3);
+        QCOMPARE(brokenSpy.count(), 1);
+    }
+
+    void testReplayTimestampWrap()
+    {
+        PointerBarrierWrapper barrier;
+        setupReplayBarrier(&barrier);
+
+        QSignalSpy brokenSpy(&barrier, SIGNAL(broken()));
+
+        // X server time wraps around in the middle of the trace
+        replayTrace(&barrier, slowPushTrace, 2, 0xFFFFFFFF - 150);
+        QCOMPARE(brokenSpy.count(), 0);
+
+        replayTrace(&barrier, slowPushTrace + 2, 1, 0xFFFFFFFF - 150);
+        QCOMPARE(brokenSpy.count(), 1);
+    }
+
     void testBreak()
     {
         Display *display = QX11Info::display();
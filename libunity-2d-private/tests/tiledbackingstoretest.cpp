@@ -0,0 +1,108 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Local
+#include <tiledbackingstore.h>
+#include <unity2dmetrics.h>
+
+// Qt
+#include <QRegion>
+#include <QtTest>
+
+static uint sentTiles()
+{
+    return Unity2dMetrics::instance()->counters().value("backingstore.tiles_sent").toUInt();
+}
+
+static uint unchangedTiles()
+{
+    return Unity2dMetrics::instance()->counters().value("backingstore.tiles_unchanged").toUInt();
+}
+
+class TiledBackingStoreTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testOnlyDirtyTilesAreSent()
+    {
+        if (!TiledBackingStore::isSupported()) {
+            QSKIP("The default visual is not 24 bits RGB", SkipAll);
+        }
+        TiledViewport viewport;
+        viewport.resize(640, 480);
+        viewport.show();
+        QTest::qWaitForWindowShown(&viewport);
+
+        QImage* image = viewport.backingStore()->beginPaint();
+        QCOMPARE(image->size(), QSize(640, 480));
+        image->fill(0xff0000);
+
+        const uint before = sentTiles();
+        const int size = TiledBackingStore::TILE_SIZE;
+        /* Two corners: their bounding rectangle is the whole viewport */
+        const QRegion region = QRegion(0, 0, 10, 10) + QRegion(630, 470, 10, 10);
+        viewport.backingStore()->flush(region);
+        QCOMPARE(sentTiles() - before, 2u);
+
+        /* A region spanning two tiles of a row */
+        viewport.backingStore()->beginPaint()->fill(0x00ff00);
+        viewport.backingStore()->flush(QRegion(size - 5, 0, 10, 10));
+        QCOMPARE(sentTiles() - before, 4u);
+    }
+
+    void testUnchangedTilesAreNotSentAgain()
+    {
+        if (!TiledBackingStore::isSupported()) {
+            QSKIP("The default visual is not 24 bits RGB", SkipAll);
+        }
+        /* Keeping a copy of what was sent is only done without shared memory */
+        qputenv("UNITY2D_DEBUG_NO_SHM", "1");
+        TiledViewport viewport;
+        qputenv("UNITY2D_DEBUG_NO_SHM", "");
+        viewport.resize(640, 480);
+        viewport.show();
+        QTest::qWaitForWindowShown(&viewport);
+
+        viewport.backingStore()->beginPaint()->fill(0xff0000);
+        QVERIFY(!viewport.backingStore()->usesSharedMemory());
+
+        const uint sentBefore = sentTiles();
+        const uint unchangedBefore = unchangedTiles();
+        const QRegion region(0, 0, 2 * TiledBackingStore::TILE_SIZE, 10);
+        viewport.backingStore()->flush(region);
+        QCOMPARE(sentTiles() - sentBefore, 2u);
+        QCOMPARE(unchangedTiles() - unchangedBefore, 0u);
+
+        /* Repainting the same pixels sends nothing */
+        viewport.backingStore()->beginPaint()->fill(0xff0000);
+        viewport.backingStore()->flush(region);
+        QCOMPARE(sentTiles() - sentBefore, 2u);
+        QCOMPARE(unchangedTiles() - unchangedBefore, 2u);
+
+        /* Unless the X server lost them */
+        viewport.backingStore()->invalidate(QRect(0, 0, 10, 10));
+        viewport.backingStore()->flush(region);
+        QCOMPARE(sentTiles() - sentBefore, 3u);
+        QCOMPARE(unchangedTiles() - unchangedBefore, 3u);
+    }
+};
+
+QTEST_MAIN(TiledBackingStoreTest)
+
+#include "tiledbackingstoretest.moc"
@@ -0,0 +1,82 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Local
+#include <unity2dmetrics.h>
+
+// Qt
+#include <QtTest>
+
+static void countTwice()
+{
+    for (int i = 0; i < 2; ++i) {
+        UQ_METRIC_COUNT("test.macro");
+    }
+}
+
+class Unity2dMetricsTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testCounter()
+    {
+        Unity2dMetrics* metrics = Unity2dMetrics::instance();
+        QCOMPARE(metrics->counter("test.counter"), metrics->counter("test.counter"));
+        metrics->counter("test.counter")->increment();
+        metrics->counter("test.counter")->increment(2);
+        QCOMPARE(metrics->counters().value("test.counter").toUInt(), 3u);
+
+        countTwice();
+        countTwice();
+        QCOMPARE(metrics->counters().value("test.macro").toUInt(), 4u);
+    }
+
+    void testGauge()
+    {
+        Unity2dMetrics* metrics = Unity2dMetrics::instance();
+        UQ_METRIC_GAUGE("test.gauge", 10);
+        metrics->gauge("test.gauge")->add(-3);
+        QCOMPARE(metrics->gauges().value("test.gauge").toInt(), 7);
+    }
+
+    void testHistogram()
+    {
+        const QList<qint64> bounds = Unity2dMetrics::bucketBounds();
+        Unity2dMetrics::Histogram* histogram = Unity2dMetrics::instance()->histogram("test.histogram");
+        histogram->record(0);
+        histogram->record(bounds.first());
+        histogram->record(bounds.first() + 1);
+        histogram->record(bounds.last() * 2);
+
+        const QVariantMap map = Unity2dMetrics::instance()->histograms().value("test.histogram").toMap();
+        QCOMPARE(map.value("count").toLongLong(), qint64(4));
+        QCOMPARE(map.value("sum").toLongLong(), 2 * bounds.first() + 1 + bounds.last() * 2);
+        QCOMPARE(map.value("max").toLongLong(), bounds.last() * 2);
+
+        const QVariantList buckets = map.value("buckets").toList();
+        QCOMPARE(buckets.count(), bounds.count() + 1);
+        QCOMPARE(buckets.at(0).toLongLong(), qint64(2));
+        QCOMPARE(buckets.at(1).toLongLong(), qint64(1));
+        QCOMPARE(buckets.last().toLongLong(), qint64(1));
+    }
+};
+
+QTEST_MAIN(Unity2dMetricsTest)
+
+#include "unity2dmetricstest.moc"
@@ -0,0 +1,54 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+// Local
+#include <unity2dmetrics.h>
+#include <wakeupmonitor.h>
+
+// Qt
+#include <QEventLoop>
+#include <QTimer>
+#include <QtTest>
+
+class WakeupMonitorTest : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void testWakeups()
+    {
+        WakeupMonitor* monitor = WakeupMonitor::instance();
+        monitor->start();
+        const uint before = Unity2dMetrics::instance()->counters().value("process.wakeups").toUInt();
+
+        /* Wake the event loop up every 20ms for a bit more than two seconds */
+        QTimer ticker;
+        ticker.start(20);
+        QEventLoop loop;
+        QTimer::singleShot(2200, &loop, SLOT(quit()));
+        loop.exec();
+        ticker.stop();
+
+        const uint after = Unity2dMetrics::instance()->counters().value("process.wakeups").toUInt();
+        QVERIFY(after - before >= 50);
+        QVERIFY(monitor->wakeupsPerSecond() >= 25);
+    }
+};
+
+QTEST_MAIN(WakeupMonitorTest)
+
+#include "wakeupmonitortest.moc"
@@ -30,11 +30,14 @@
 #include <hotkey.h>
 
 // Unity
+#include <metricsdbus.h>
 #include <unity2dpanel.h>
+#include <unity2dtrace.h>
 #include <panelappletproviderinterface.h>
 
 // Qt
 #include <QApplication>
+#include <QDBusConnection>
 #include <QDebug>
 #include <QDesktopWidget>
 #include <QDir>
@@ -47,6 +50,7 @@
 using namespace Unity2d;
 
 static const char* PANEL_DCONF_PROPERTY_APPLETS = "applets";
+static const char* PANEL_DCONF_PROPERTY_SHARED_INDICATORS = "sharedIndicators";
 static const char* PANEL_PLUGINS_DEV_DIR_ENV = "UNITY2D_PANEL_PLUGINS_PATH";
 
 static QHash<QString, PanelAppletProviderInterface*> loadPlugins()
@@ -116,9 +120,23 @@ QStringList PanelManager::loadPanelConfiguration() const
 PanelManager::PanelManager(QObject* parent)
 : QObject(parent)
 {
+    UQ_TRACE_SCOPE("PanelManager");
+
+    /* The panel has no D-Bus API and owns no well-known name: its metrics are
+       only reachable through its unique connection name */
+    MetricsDBus* metricsDBus = new MetricsDBus(this);
+    if (metricsDBus->connectToBus()) {
+        qDebug() << "Metrics published on" << QDBusConnection::sessionBus().baseService();
+    }
+
     Unity2dPanel* panel;
     QDesktopWidget* desktop = QApplication::desktop();
 
+    /* Panels on all screens show the same indicators: unless disabled, receive
+       their state once and let each panel only render it */
+    bool sharedIndicators = panel2dConfiguration().property(PANEL_DCONF_PROPERTY_SHARED_INDICATORS).toBool();
+    IndicatorsManager::setSharedIndicators(sharedIndicators);
+
     QPoint p;
     if (QApplication::isRightToLeft()) {
         p = QPoint(desktop->width() - 1, 0);
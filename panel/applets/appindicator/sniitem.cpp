@@ -23,26 +23,131 @@
 
 // Local
 #include "debug_p.h"
+#include "unity2dmetrics.h"
 
 // dbusmenu-qt
 #include <dbusmenuimporter.h>
 
 // Qt
 #include <QAction>
+#include <QCache>
+#include <QDBusArgument>
+#include <QDBusMetaType>
 #include <QDBusPendingCallWatcher>
 #include <QDBusPendingReply>
+#include <QDBusVariant>
+#include <QImage>
 #include <QMenuBar>
+#include <QTimer>
 #include <QVariant>
+#include <QtEndian>
+
+// libc
+#include <string.h>
 
 static const char* SNI_IFACE = "org.kde.StatusNotifierItem";
 static const char* FDO_PROPERTIES_IFACE = "org.freedesktop.DBus.Properties";
 
+// Some applications animate their icon several times per second: the changes
+// arriving within this interval are fetched together, so that an animated icon
+// is fetched at most 20 times per second but keeps being updated
+static const int UPDATE_DEBOUNCE_INTERVAL = 50;
+
+static const int ICON_CACHE_MAX_BYTES = 1024 * 1024;
+
+/**
+ * One of the images of the IconPixmap property, as ARGB32 in network byte
+ * order
+ */
+struct SNIIconPixmap
+{
+    int width;
+    int height;
+    QByteArray data;
+};
+typedef QList<SNIIconPixmap> SNIIconPixmapList;
+
+Q_DECLARE_METATYPE(SNIIconPixmap)
+Q_DECLARE_METATYPE(SNIIconPixmapList)
+
+// The same bytes make a different image at another size
+static bool operator==(const SNIIconPixmap& pixmap1, const SNIIconPixmap& pixmap2)
+{
+    return pixmap1.width == pixmap2.width && pixmap1.height == pixmap2.height
+        && pixmap1.data == pixmap2.data;
+}
+
+static uint qHash(const SNIIconPixmap& pixmap)
+{
+    return qHash(pixmap.data) ^ uint(pixmap.width << 16) ^ uint(pixmap.height);
+}
+
+const QDBusArgument& operator>>(const QDBusArgument& argument, SNIIconPixmap& pixmap)
+{
+    argument.beginStructure();
+    argument >> pixmap.width >> pixmap.height >> pixmap.data;
+    argument.endStructure();
+    return argument;
+}
+
+QDBusArgument& operator<<(QDBusArgument& argument, const SNIIconPixmap& pixmap)
+{
+    argument.beginStructure();
+    argument << pixmap.width << pixmap.height << pixmap.data;
+    argument.endStructure();
+    return argument;
+}
+
+static QImage decodeIconPixmap(const SNIIconPixmap& pixmap)
+{
+    // Animated icons cycle through a few frames, keep them decoded. The data
+    // is implicitly shared with the reply, so using the pixmap as key is cheap.
+    static QCache<SNIIconPixmap, QImage> cache(ICON_CACHE_MAX_BYTES);
+    if (QImage* image = cache.object(pixmap)) {
+        return *image;
+    }
+
+    const int count = pixmap.width * pixmap.height;
+    if (pixmap.width <= 0 || pixmap.height <= 0 || pixmap.data.size() < count * 4) {
+        UQ_WARNING << "Invalid IconPixmap of size" << pixmap.width << "x" << pixmap.height;
+        return QImage();
+    }
+
+    QImage image(pixmap.width, pixmap.height, QImage::Format_ARGB32);
+    const uchar* src = reinterpret_cast<const uchar*>(pixmap.data.constData());
+    quint32* dst = reinterpret_cast<quint32*>(image.bits());
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    memcpy(dst, src, count * 4);
+#else
+    // Straight loop the compiler turns into vector byte swaps
+    for (int i = 0; i < count; ++i) {
+        dst[i] = qFromBigEndian<quint32>(src + i * 4);
+    }
+#endif
+
+    cache.insert(pixmap, new QImage(image), count * 4 + pixmap.data.size());
+    return image;
+}
+
 SNIItem::SNIItem(const QString& service, const QString& path, QMenuBar* menuBar)
 : QObject(menuBar)
 , m_iface(service, path, SNI_IFACE)
 , m_menuBar(menuBar)
 , m_action(new QAction(this))
+, m_updateTimer(new QTimer(this))
 {
+    qDBusRegisterMetaType<SNIIconPixmap>();
+    qDBusRegisterMetaType<SNIIconPixmapList>();
+
+    m_updateTimer->setInterval(UPDATE_DEBOUNCE_INTERVAL);
+    m_updateTimer->setSingleShot(true);
+    connect(m_updateTimer, SIGNAL(timeout()), SLOT(fetchChangedProperties()));
+
+    QDBusConnection connection = m_iface.connection();
+    connection.connect(service, path, SNI_IFACE, "NewIcon", this, SLOT(slotNewIcon()));
+    connection.connect(service, path, SNI_IFACE, "NewStatus", this, SLOT(slotNewStatus()));
+    connection.connect(service, path, SNI_IFACE, "NewTitle", this, SLOT(slotNewTitle()));
+
     m_menuBar->setNativeMenuBar(false);
     m_menuBar->addAction(m_action);
     updateFromDBus();
@@ -52,6 +157,7 @@ void SNIItem::updateFromDBus()
 {
     QDBusMessage call = QDBusMessage::createMethodCall(m_iface.service(), m_iface.path(), FDO_PROPERTIES_IFACE, "GetAll");
     call.setArguments(QVariantList() << QString(SNI_IFACE));
+    UQ_METRIC_COUNT("dbus.calls");
     QDBusPendingCall reply = m_iface.connection().asyncCall(call);
     QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(reply, this);
 
@@ -71,18 +177,108 @@ void SNIItem::slotPropertiesReceived(QDBusPendingCallWatcher* watcher)
 
 void SNIItem::updateFromProperties(const QVariantMap& map)
 {
-    QVariant value;
-    value = map.value("IconName");
-    if (value.isValid()) {
-        QIcon icon = QIcon::fromTheme(value.toString());
-        m_action->setIcon(icon);
+    QVariantMap::const_iterator it = map.constBegin();
+    for (; it != map.constEnd(); ++it) {
+        updateProperty(it.key(), it.value());
     }
-    value = map.value("Menu");
-    if (value.isValid()) {
+    updateIcon();
+}
+
+void SNIItem::slotNewIcon()
+{
+    scheduleFetch(QStringList() << "IconName" << "IconPixmap");
+}
+
+void SNIItem::slotNewStatus()
+{
+    scheduleFetch(QStringList() << "Status");
+}
+
+void SNIItem::slotNewTitle()
+{
+    scheduleFetch(QStringList() << "Title");
+}
+
+void SNIItem::scheduleFetch(const QStringList& properties)
+{
+    Q_FOREACH(const QString& property, properties) {
+        m_changedProperties.insert(property);
+    }
+    // Not restarted by further changes, which would delay the fetch for as
+    // long as the icon animates
+    if (!m_updateTimer->isActive()) {
+        m_updateTimer->start();
+    }
+}
+
+void SNIItem::fetchChangedProperties()
+{
+    Q_FOREACH(const QString& property, m_changedProperties) {
+        QDBusMessage call = QDBusMessage::createMethodCall(m_iface.service(), m_iface.path(), FDO_PROPERTIES_IFACE, "Get");
+        call.setArguments(QVariantList() << QString(SNI_IFACE) << property);
+        UQ_METRIC_COUNT("dbus.calls");
+        QDBusPendingCall reply = m_iface.connection().asyncCall(call);
+        QDBusPendingCallWatcher* watcher = new QDBusPendingCallWatcher(reply, this);
+        watcher->setProperty("propertyName", property);
+
+        connect(watcher, SIGNAL(finished(QDBusPendingCallWatcher*)), SLOT(slotPropertyReceived(QDBusPendingCallWatcher*)));
+    }
+    m_changedProperties.clear();
+}
+
+void SNIItem::slotPropertyReceived(QDBusPendingCallWatcher* watcher)
+{
+    watcher->deleteLater();
+    QString name = watcher->property("propertyName").toString();
+    QDBusPendingReply<QDBusVariant> reply = *watcher;
+    if (!reply.isError()) {
+        updateProperty(name, reply.value().variant());
+        if (name.startsWith("Icon")) {
+            updateIcon();
+        }
+    } else {
+        UQ_WARNING << "Get" << name << "failed:" << reply.error();
+    }
+}
+
+void SNIItem::updateProperty(const QString& name, const QVariant& value)
+{
+    if (name == "IconName") {
+        m_iconName = value.toString();
+    } else if (name == "IconPixmap") {
+        SNIIconPixmapList pixmaps;
+        if (value.canConvert<QDBusArgument>()) {
+            pixmaps = qdbus_cast<SNIIconPixmapList>(value.value<QDBusArgument>());
+        }
+        m_pixmapIcon = QIcon();
+        Q_FOREACH(const SNIIconPixmap& pixmap, pixmaps) {
+            QImage image = decodeIconPixmap(pixmap);
+            if (!image.isNull()) {
+                m_pixmapIcon.addPixmap(QPixmap::fromImage(image));
+            }
+        }
+    } else if (name == "Status") {
+        m_action->setVisible(value.toString() != "Passive");
+    } else if (name == "Title") {
+        m_action->setToolTip(value.toString());
+    } else if (name == "Menu") {
         QDBusObjectPath path = value.value<QDBusObjectPath>();
         m_importer.reset(new DBusMenuImporter(m_iface.service(), path.path()));
         m_action->setMenu(m_importer->menu());
     }
 }
 
+void SNIItem::updateIcon()
+{
+    // Themed icons are preferred, IconPixmap is the fallback
+    QIcon icon;
+    if (!m_iconName.isEmpty()) {
+        icon = QIcon::fromTheme(m_iconName);
+    }
+    if (icon.isNull()) {
+        icon = m_pixmapIcon;
+    }
+    m_action->setIcon(icon);
+}
+
 #include "sniitem.moc"
@@ -24,13 +24,16 @@
 
 // Qt
 #include <QDBusInterface>
+#include <QIcon>
 #include <QObject>
+#include <QSet>
 
 class DBusMenuImporter;
 
 class QAction;
 class QDBusPendingCallWatcher;
 class QMenuBar;
+class QTimer;
 
 class SNIItem : public QObject
 {
@@ -40,14 +43,26 @@ public:
 
 private Q_SLOTS:
     void slotPropertiesReceived(QDBusPendingCallWatcher*);
+    void slotPropertyReceived(QDBusPendingCallWatcher*);
+    void slotNewIcon();
+    void slotNewStatus();
+    void slotNewTitle();
+    void fetchChangedProperties();
 
 private:
     QDBusInterface m_iface;
     QMenuBar* m_menuBar;
     QAction* m_action;
     QScopedPointer<DBusMenuImporter> m_importer;
+    QTimer* m_updateTimer;
+    QSet<QString> m_changedProperties;
+    QString m_iconName;
+    QIcon m_pixmapIcon;
     void updateFromDBus();
     void updateFromProperties(const QVariantMap&);
+    void updateProperty(const QString& name, const QVariant& value);
+    void updateIcon();
+    void scheduleFetch(const QStringList& properties);
 };
 
 #endif // SNIITEM_H
@@ -52,6 +52,7 @@
 #include <QLinearGradient>
 #include <QMenuBar>
 #include <QPainter>
+#include <QPixmapCache>
 #include <QApplication>
 #include <QDesktopWidget>
 #include <QMouseEvent>
@@ -59,6 +60,18 @@
 
 static const int APPNAME_LABEL_LEFT_MARGIN = 6;
 
+// Dash buttons change type whenever the active window is (un)maximized, do
+// not load their artwork from disk each time
+static QPixmap loadCachedPixmap(const QString& path)
+{
+    QPixmap pix;
+    if (!QPixmapCache::find(path, &pix)) {
+        pix.load(path);
+        QPixmapCache::insert(path, pix);
+    }
+    return pix;
+}
+
 class WindowButton : public QAbstractButton
 {
 public:
@@ -186,13 +199,13 @@ private:
         case PanelStyle::MaximizeWindowButton:
             iconPath += "maximize_dash";
             /* we have disabled asset only for maximize button */
-            m_dash_disabledPix.load(iconPath + "_disabled.png");
+            m_dash_disabledPix = loadCachedPixmap(iconPath + "_disabled.png");
             break;
         }
 
-        m_dash_normalPix.load(iconPath + ".png");
-        m_dash_hoverPix.load(iconPath + "_prelight.png");
-        m_dash_downPix.load(iconPath + "_pressed.png");
+        m_dash_normalPix = loadCachedPixmap(iconPath + ".png");
+        m_dash_hoverPix = loadCachedPixmap(iconPath + "_prelight.png");
+        m_dash_downPix = loadCachedPixmap(iconPath + "_pressed.png");
     }
 };
 
@@ -35,17 +35,24 @@
 #include <QApplication>
 #include <QImage>
 #include <QPainter>
+#include <QTimer>
 
 // GTK
 #include <gtk/gtk.h>
 
 static const int FADEOUT_WIDTH = 30;
 
+// Titles changing faster than this, such as terminals or progress in browser
+// tabs, are only rendered again once per frame
+static const int MIN_RENDER_INTERVAL = 16;
+
 static const char* WINDOW_TITLE_FONT_KEY = "/apps/metacity/general/titlebar_font";
 
 CroppedLabel::CroppedLabel(QWidget* parent)
 : QLabel(parent)
 , m_gconfItem(new GConfItemQmlWrapper(this))
+, m_cachePaletteKey(0)
+, m_cacheLayoutDirection(Qt::LeftToRight)
 {
     QObject::connect(m_gconfItem, SIGNAL(valueChanged()),
                      this, SLOT(onWindowTitleFontNameChanged()));
@@ -71,7 +78,7 @@ static void paintFadeoutGradient(QImage* image)
     painter.fillRect(gradientRect, gradient);
 }
 
-void CroppedLabel::paintEvent(QPaintEvent* event)
+QImage CroppedLabel::renderTitle() const
 {
     // Create an image filled with background brush (to avoid subpixel hinting
     // artefacts around text)
@@ -135,9 +142,42 @@ void CroppedLabel::paintEvent(QPaintEvent* event)
         paintFadeoutGradient(&image);
     }
 
+    return image;
+}
+
+bool CroppedLabel::isCacheValid() const
+{
+    return !m_cachePixmap.isNull()
+        && m_cacheText == text()
+        && m_cacheFontName == m_windowTitleFontName
+        && m_cachePaletteKey == palette().cacheKey()
+        && m_cacheContentsRect == contentsRect()
+        && m_cachePixmap.size() == size()
+        && m_cacheLayoutDirection == QApplication::layoutDirection();
+}
+
+void CroppedLabel::paintEvent(QPaintEvent* event)
+{
+    if (!isCacheValid()) {
+        int elapsed = m_lastRenderTimer.isValid() ? m_lastRenderTimer.elapsed() : MIN_RENDER_INTERVAL;
+        if (elapsed < MIN_RENDER_INTERVAL && m_cachePixmap.size() == size()) {
+            // Only the content changed, keep showing the previous title
+            // until the next frame
+            QTimer::singleShot(MIN_RENDER_INTERVAL - elapsed, this, SLOT(update()));
+        } else {
+            m_cachePixmap = QPixmap::fromImage(renderTitle());
+            m_cacheText = text();
+            m_cacheFontName = m_windowTitleFontName;
+            m_cachePaletteKey = palette().cacheKey();
+            m_cacheContentsRect = contentsRect();
+            m_cacheLayoutDirection = QApplication::layoutDirection();
+            m_lastRenderTimer.start();
+        }
+    }
+
     // Paint on our widget
     QPainter painter(this);
-    painter.drawImage(0, 0, image);
+    painter.drawPixmap(0, 0, m_cachePixmap);
 }
 
 void CroppedLabel::onWindowTitleFontNameChanged()
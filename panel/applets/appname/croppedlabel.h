@@ -24,7 +24,9 @@
 // Local
 
 // Qt
+#include <QElapsedTimer>
 #include <QLabel>
+#include <QPixmap>
 
 class GConfItemQmlWrapper;
 
@@ -49,6 +51,18 @@ private Q_SLOTS:
 private:
     GConfItemQmlWrapper *m_gconfItem;
     QString m_windowTitleFontName;
+
+    // Cached rendering of the faded title, and what it was rendered from
+    QPixmap m_cachePixmap;
+    QString m_cacheText;
+    QString m_cacheFontName;
+    qint64 m_cachePaletteKey;
+    QRect m_cacheContentsRect;
+    Qt::LayoutDirection m_cacheLayoutDirection;
+    QElapsedTimer m_lastRenderTimer;
+
+    bool isCacheValid() const;
+    QImage renderTitle() const;
 };
 
 #endif /* CROPPEDLABEL_H */
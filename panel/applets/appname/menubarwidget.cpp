@@ -28,7 +28,9 @@
 #include <indicatorsmanager.h>
 
 // Qt
+#include <QHash>
 #include <QHBoxLayout>
+#include <QTimer>
 
 static const int MENU_ITEM_PADDING = 6;
 
@@ -38,7 +40,14 @@ MenuBarWidget::MenuBarWidget(IndicatorsManager* indicatorsManager, QWidget* pare
 , m_layout(new QHBoxLayout(this))
 , m_isEmpty(true)
 , m_isOpened(false)
+, m_syncTimer(new QTimer(this))
 {
+    // Entries are added and removed one by one as the indicator syncs,
+    // reflect all the changes of a sync at once
+    m_syncTimer->setInterval(0);
+    m_syncTimer->setSingleShot(true);
+    connect(m_syncTimer, SIGNAL(timeout()), SLOT(syncEntries()));
+
     m_layout->setMargin(0);
     m_layout->setSpacing(0);
     indicatorsManager->indicators()->on_object_added.connect(
@@ -52,6 +61,11 @@ MenuBarWidget::MenuBarWidget(IndicatorsManager* indicatorsManager, QWidget* pare
         );
     setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Minimum);
     m_layout->addStretch();
+
+    // Indicators may be shared with another panel and already known
+    Q_FOREACH(const unity::indicator::Indicator::Ptr& indicator, indicatorsManager->indicators()->GetIndicators()) {
+        onObjectAdded(indicator);
+    }
 }
 
 MenuBarWidget::~MenuBarWidget()
@@ -95,53 +109,93 @@ void MenuBarWidget::onObjectAdded(const unity::indicator::Indicator::Ptr& indica
         entry_removed = m_indicator->on_entry_removed.connect(
                             sigc::mem_fun(this, &MenuBarWidget::onEntryRemoved)
                         );
+        // The indicator may be shared with another panel and already have
+        // entries
+        m_syncTimer->start();
     }
 }
 
 void MenuBarWidget::onObjectRemoved(const unity::indicator::Indicator::Ptr& indicator)
 {
-    QString name = QString::fromStdString(indicator->name());
     if (indicator->IsAppmenu() && indicator.get()) {
         entry_added.disconnect();
         entry_removed.disconnect();
-
-        Q_FOREACH(const unity::indicator::Entry::Ptr& entry, m_indicator->GetEntries())
-        {
-            onEntryRemoved (entry->id());
-        }
-
         m_indicator.reset();
+        m_syncTimer->start();
     }
 }
 
-void MenuBarWidget::onEntryAdded(const unity::indicator::Entry::Ptr& entry)
+void MenuBarWidget::onEntryAdded(const unity::indicator::Entry::Ptr& /*entry*/)
+{
+    m_syncTimer->start();
+}
+
+void MenuBarWidget::onEntryRemoved(const std::string& /*entry_id*/)
+{
+    m_syncTimer->start();
+}
+
+IndicatorEntryWidget* MenuBarWidget::createEntryWidget(const unity::indicator::Entry::Ptr& entry)
 {
     IndicatorEntryWidget* widget = new IndicatorEntryWidget(entry);
     widget->setPadding(MENU_ITEM_PADDING);
     connect(widget, SIGNAL(isEmptyChanged()), SLOT(updateIsEmpty()));
-
-    m_widgetList.append(widget);
     m_indicatorsManager->addIndicatorEntryWidget(widget);
+    return widget;
+}
 
-    // Insert *before* stretch
-    m_layout->insertWidget(m_layout->count() - 1, widget);
+void MenuBarWidget::deleteEntryWidget(IndicatorEntryWidget* widget)
+{
+    disconnect(widget, SIGNAL(isEmptyChanged()));
+    widget->hide();
+    m_layout->removeWidget(widget);
+    m_indicatorsManager->removeIndicatorEntryWidget(widget);
+    delete widget;
 }
 
-void MenuBarWidget::onEntryRemoved(const std::string& entry_id)
+void MenuBarWidget::syncEntries()
 {
-    Q_FOREACH(IndicatorEntryWidget* widget, m_widgetList)
-    {
-        if (widget->entry()->id() == entry_id) {
-            disconnect(widget, SIGNAL(isEmptyChanged()));
-            widget->hide();
+    unity::indicator::Entry::List entries;
+    if (m_indicator) {
+        entries = m_indicator->GetEntries();
+    }
+
+    // Reuse the widgets of entries we already know
+    QHash<QString, IndicatorEntryWidget*> oldWidgets;
+    Q_FOREACH(IndicatorEntryWidget* widget, m_widgetList) {
+        oldWidgets.insert(QString::fromStdString(widget->entry()->id()), widget);
+    }
+
+    QList<IndicatorEntryWidget*> widgetList;
+    Q_FOREACH(const unity::indicator::Entry::Ptr& entry, entries) {
+        IndicatorEntryWidget* widget = oldWidgets.take(QString::fromStdString(entry->id()));
+        if (widget && widget->entry() != entry) {
+            deleteEntryWidget(widget);
+            widget = 0;
+        }
+        if (!widget) {
+            widget = createEntryWidget(entry);
+        }
+        widgetList.append(widget);
+    }
+
+    Q_FOREACH(IndicatorEntryWidget* widget, oldWidgets) {
+        deleteEntryWidget(widget);
+    }
+
+    if (widgetList != m_widgetList) {
+        // Insert *before* stretch, in the indicator order. The layout is only
+        // updated once, when it processes its LayoutRequest event.
+        Q_FOREACH(IndicatorEntryWidget* widget, widgetList) {
             m_layout->removeWidget(widget);
-            m_indicatorsManager->removeIndicatorEntryWidget(widget);
-            m_widgetList.removeOne(widget);
-            delete widget;
-            updateIsEmpty();
-            break;
         }
+        for (int i = 0; i < widgetList.count(); ++i) {
+            m_layout->insertWidget(i, widgetList.at(i));
+        }
+        m_widgetList = widgetList;
     }
+
+    updateIsEmpty();
 }
 
 void MenuBarWidget::updateIsEmpty()
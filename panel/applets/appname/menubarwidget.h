@@ -32,6 +32,7 @@
 #include <sigc++/connection.h>
 
 class QHBoxLayout;
+class QTimer;
 
 class IndicatorEntryWidget;
 class IndicatorsManager;
@@ -54,6 +55,7 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void updateIsEmpty();
+    void syncEntries();
 
 private:
     Q_DISABLE_COPY(MenuBarWidget)
@@ -66,7 +68,10 @@ private:
     bool m_isEmpty;
     bool m_isOpened;
     QList<IndicatorEntryWidget*> m_widgetList;
+    QTimer* m_syncTimer;
 
+    IndicatorEntryWidget* createEntryWidget(const unity::indicator::Entry::Ptr&);
+    void deleteEntryWidget(IndicatorEntryWidget*);
     void onObjectAdded(const unity::indicator::Indicator::Ptr&);
     void onObjectRemoved(const unity::indicator::Indicator::Ptr&);
     void onEntryAdded(const unity::indicator::Entry::Ptr&);
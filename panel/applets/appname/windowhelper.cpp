@@ -53,6 +53,7 @@ extern "C" {
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
 #include <QX11Info>
+#include <x11properties.h>
 
 struct WindowHelperPrivate
 {
@@ -259,7 +260,7 @@ void WindowHelper::drag(const QPoint& pos)
         if (wnck_window_is_maximized(d->m_window)) {
             XEvent xev;
             QX11Info info;
-            Atom netMoveResize = XInternAtom(QX11Info::display(), "_NET_WM_MOVERESIZE", false);
+            Atom netMoveResize = X11Properties::instance()->atom("_NET_WM_MOVERESIZE");
             xev.xclient.type = ClientMessage;
             xev.xclient.message_type = netMoveResize;
             xev.xclient.display = QX11Info::display();
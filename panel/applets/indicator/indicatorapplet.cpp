@@ -59,6 +59,11 @@ IndicatorApplet::IndicatorApplet(Unity2dPanel* panel)
     m_indicatorsWidget = new IndicatorsWidget(m_indicatorsManager);
     layout->addWidget(m_indicatorsWidget);
 
+    // Indicators may be shared with another panel and already known
+    Q_FOREACH(const Indicator::Ptr& indicator, m_indicatorsManager->indicators()->GetIndicators()) {
+        onObjectAdded(indicator);
+    }
+
     if (panel != NULL) {
         panel->installEventFilter(this);
     }
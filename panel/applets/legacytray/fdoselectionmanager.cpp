@@ -23,12 +23,14 @@
 #include <debug_p.h>
 
 #include "fdotask.h"
+#include "x11embedcontainer.h"
 #include "x11embedpainter.h"
 /* UQ
 #include <KDebug>
 */
 #include <QtCore/QCoreApplication>
 #include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QTimer>
 
 #include <QtGui/QTextDocument>
@@ -61,14 +63,21 @@ namespace SystemTray
 static FdoSelectionManager *s_manager = 0;
 static X11EmbedPainter *s_painter = 0;
 
+// Damage is fetched at most once per frame for each client
+static const int DAMAGE_COALESCING_INTERVAL = 16;
+
 struct DamageWatch
 {
-    QWidget *container;
+    X11EmbedContainer *container;
+    WId client;
     Damage damage;
 };
 
 static int damageEventBase = 0;
-static QMap<WId, DamageWatch*> damageWatches;
+static QHash<WId, DamageWatch*> damageWatchesByClient;
+static QHash<X11EmbedContainer*, DamageWatch*> damageWatchesByContainer;
+static QSet<WId> pendingDamage;
+static QTimer *damageTimer = 0;
 static QCoreApplication::EventFilter oldEventFilter;
 
 // Global event filter for intercepting damage events
@@ -77,14 +86,13 @@ static bool x11EventFilter(void *message, long int *result)
     XEvent *event = reinterpret_cast<XEvent*>(message);
     if (event->type == damageEventBase + XDamageNotify) {
         XDamageNotifyEvent *e = reinterpret_cast<XDamageNotifyEvent*>(event);
-        if (DamageWatch *damageWatch = damageWatches.value(e->drawable)) {
-            // Create a new region and empty the damage region into it.
-            // The window is small enough that we don't really care about the region;
-            // we'll just throw it away and schedule a full repaint of the container.
-            XserverRegion region = XFixesCreateRegion(e->display, 0, 0);
-            XDamageSubtract(e->display, e->damage, None, region);
-            XFixesDestroyRegion(e->display, region);
-            damageWatch->container->update();
+        // With XDamageReportNonEmpty, no other event is sent for this client
+        // until its damage is subtracted in processDamage()
+        if (damageWatchesByClient.contains(e->drawable) && damageTimer) {
+            pendingDamage.insert(e->drawable);
+            if (!damageTimer->isActive()) {
+                damageTimer->start();
+            }
         }
     }
 
@@ -127,6 +135,11 @@ public:
         if (haveXfixes && haveXdamage && haveXComposite) {
             haveComposite = true;
             oldEventFilter = QCoreApplication::instance()->setEventFilter(x11EventFilter);
+
+            damageTimer = new QTimer(q);
+            damageTimer->setSingleShot(true);
+            damageTimer->setInterval(DAMAGE_COALESCING_INTERVAL);
+            QObject::connect(damageTimer, SIGNAL(timeout()), q, SLOT(processDamage()));
         }
     }
 
@@ -169,6 +182,8 @@ FdoSelectionManager::~FdoSelectionManager()
     if (d->haveComposite && QCoreApplication::instance()) {
         QCoreApplication::instance()->setEventFilter(oldEventFilter);
     }
+    // Deleted with us
+    damageTimer = 0;
 
     if (s_manager == this) {
         s_manager = 0;
@@ -189,26 +204,56 @@ X11EmbedPainter *FdoSelectionManager::painter()
     return s_painter;
 }
 
-void FdoSelectionManager::addDamageWatch(QWidget *container, WId client)
+void FdoSelectionManager::addDamageWatch(X11EmbedContainer *container, WId client)
 {
     DamageWatch *damage = new DamageWatch;
     damage->container = container;
+    damage->client = client;
     damage->damage = XDamageCreate(QX11Info::display(), client, XDamageReportNonEmpty);
-    damageWatches.insert(client, damage);
+    damageWatchesByClient.insert(client, damage);
+    damageWatchesByContainer.insert(container, damage);
 }
 
-void FdoSelectionManager::removeDamageWatch(QWidget *container)
+void FdoSelectionManager::removeDamageWatch(X11EmbedContainer *container)
 {
-    for (QMap<WId, DamageWatch*>::Iterator it = damageWatches.begin(); it != damageWatches.end(); ++it)
-    {
-        DamageWatch *damage = *(it);
-        if (damage->container == container) {
-             XDamageDestroy(QX11Info::display(), damage->damage);
-             damageWatches.erase(it);
-             delete damage;
-             break;
-        } 
+    DamageWatch *damage = damageWatchesByContainer.take(container);
+    if (!damage) {
+        return;
+    }
+    XDamageDestroy(QX11Info::display(), damage->damage);
+    damageWatchesByClient.remove(damage->client);
+    pendingDamage.remove(damage->client);
+    delete damage;
+}
+
+void FdoSelectionManager::processDamage()
+{
+    Display *display = QX11Info::display();
+    XserverRegion region = XFixesCreateRegion(display, 0, 0);
+
+    Q_FOREACH(WId client, pendingDamage) {
+        DamageWatch *damage = damageWatchesByClient.value(client);
+        if (!damage) {
+            continue;
+        }
+        // Move the damage region into ours, so that only the damaged parts
+        // of the container get fetched and repainted
+        XDamageSubtract(display, damage->damage, None, region);
+
+        int count = 0;
+        XRectangle *rects = XFixesFetchRegion(display, region, &count);
+        QRegion damagedRegion;
+        for (int i = 0; i < count; ++i) {
+            damagedRegion += QRect(rects[i].x, rects[i].y, rects[i].width, rects[i].height);
+        }
+        if (rects) {
+            XFree(rects);
+        }
+        damage->container->addDamage(damagedRegion);
     }
+    pendingDamage.clear();
+
+    XFixesDestroyRegion(display, region);
 }
 
 
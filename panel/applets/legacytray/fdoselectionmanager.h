@@ -29,6 +29,7 @@ namespace SystemTray
 
 class Notification;
 class Task;
+class X11EmbedContainer;
 class X11EmbedPainter;
 class FdoSelectionManagerPrivate;
 
@@ -43,8 +44,8 @@ public:
     FdoSelectionManager();
     ~FdoSelectionManager();
 
-    void addDamageWatch(QWidget *container, WId client);
-    void removeDamageWatch(QWidget *container);
+    void addDamageWatch(X11EmbedContainer *container, WId client);
+    void removeDamageWatch(X11EmbedContainer *container);
     bool haveComposite() const;
 
 Q_SIGNALS:
@@ -57,6 +58,7 @@ protected:
 private Q_SLOTS:
     void initSelection();
     void cleanupTask(WId winId);
+    void processDamage();
 
 private:
     friend class FdoSelectionManagerPrivate;
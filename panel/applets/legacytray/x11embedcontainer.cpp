@@ -43,13 +43,21 @@
 namespace SystemTray
 {
 
+// With the raster or OpenGL graphics systems, a QPixmap isn't an X pixmap
+static bool pixmapsAreX11()
+{
+    static bool x11 = QPixmap(1, 1).paintEngine()->type() == QPaintEngine::X11;
+    return x11;
+}
+
 class X11EmbedContainer::Private
 {
 public:
     Private(X11EmbedContainer *q)
         : q(q),
           picture(None),
-          updatesEnabled(true)
+          updatesEnabled(true),
+          cacheValid(false)
     {
     }
 
@@ -60,15 +68,129 @@ public:
         }
     }
 
+    void updateImageCache();
+    void updatePixmapCache();
+    XImage *getFullImage(Pixmap windowPixmap);
+
     X11EmbedContainer *q;
 
     XWindowAttributes attr;
     Picture picture;
     bool updatesEnabled;
     QImage oldBackgroundImage;
+
+    // Client side copy of the composited client content, only the damaged
+    // parts of it are fetched again
+    QImage image;
+    QPixmap pixmap;
+    QRegion damage;
+    bool cacheValid;
 };
 
 
+XImage *X11EmbedContainer::Private::getFullImage(Pixmap windowPixmap)
+{
+    Display *dpy = QX11Info::display();
+
+    // Extract XImage from pixmap, trying to cope with different behaviors.
+    // There are two possible sizes:
+    // #1: width() x height(), which is 24 x 24 in our situation
+    // #2: attr.width x attr.height
+    //
+    // - Mumble 1.2.3 returns a correct image when asked for an image of
+    // size #1 , but returns a 22 x 22 cropped icon when asked for an image
+    // of size #2.
+    //
+    // - Pidgin 2.7.9 returns a NULL image when asked for an image of size
+    // #1 but returns a correct 16 x 16 image when asked for an image of
+    // size #2.
+    XImage *ximage = XGetImage(dpy, windowPixmap, 0, 0, q->width(), q->height(), AllPlanes, ZPixmap);
+    if (!ximage) {
+        // Make sure the attr are updated, Pidgin changes its widthxheight late in the game
+        if (!XGetWindowAttributes(dpy, q->clientWinId(), &attr)) {
+            return 0;
+        }
+
+        int ximageWidth = qMin(attr.width, q->width());
+        int ximageHeight = qMin(attr.height, q->height());
+        ximage = XGetImage(dpy, windowPixmap, 0, 0, ximageWidth, ximageHeight, AllPlanes, ZPixmap);
+    }
+    return ximage;
+}
+
+
+void X11EmbedContainer::Private::updateImageCache()
+{
+    if (cacheValid && damage.isEmpty()) {
+        return;
+    }
+
+    Display *dpy = QX11Info::display();
+    Pixmap windowPixmap = XCompositeNameWindowPixmap(dpy, q->clientWinId());
+
+    if (!cacheValid) {
+        XImage *ximage = getFullImage(windowPixmap);
+        XFreePixmap(dpy, windowPixmap);
+        if (!ximage) {
+            UQ_WARNING << "Failed to get an XImage from X11 window with XID=" << q->clientWinId();
+            image = QImage();
+            return;
+        }
+        // This is safe to do since we only composite ARGB32 windows, and PictStandardARGB32
+        // matches QImage::Format_ARGB32_Premultiplied.
+        image = QImage((const uchar*)ximage->data, ximage->width, ximage->height, ximage->bytes_per_line,
+                       QImage::Format_ARGB32_Premultiplied).copy();
+        XDestroyImage(ximage);
+        damage = QRegion();
+        cacheValid = true;
+        return;
+    }
+
+    QPainter painter(&image);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    Q_FOREACH(QRect rect, damage.rects()) {
+        rect &= image.rect();
+        if (rect.isEmpty()) {
+            continue;
+        }
+        XImage *ximage = XGetImage(dpy, windowPixmap, rect.x(), rect.y(), rect.width(), rect.height(),
+                                   AllPlanes, ZPixmap);
+        if (!ximage) {
+            // The client probably got resized, start again from scratch
+            cacheValid = false;
+            continue;
+        }
+        QImage part((const uchar*)ximage->data, ximage->width, ximage->height, ximage->bytes_per_line,
+                    QImage::Format_ARGB32_Premultiplied);
+        painter.drawImage(rect.topLeft(), part);
+        XDestroyImage(ximage);
+    }
+    painter.end();
+    XFreePixmap(dpy, windowPixmap);
+    damage = QRegion();
+}
+
+
+void X11EmbedContainer::Private::updatePixmapCache()
+{
+    if (!cacheValid || pixmap.size() != q->size()) {
+        pixmap = QPixmap(q->size());
+        damage = QRegion(pixmap.rect());
+        cacheValid = true;
+    }
+    if (damage.isEmpty()) {
+        return;
+    }
+
+    Display *dpy = QX11Info::display();
+    Q_FOREACH(const QRect &rect, damage.rects()) {
+        XRenderComposite(dpy, PictOpSrc, picture, None, pixmap.x11PictureHandle(),
+                         rect.x(), rect.y(), 0, 0, rect.x(), rect.y(), rect.width(), rect.height());
+    }
+    damage = QRegion();
+}
+
+
 X11EmbedContainer::X11EmbedContainer(QWidget *parent)
     : QX11EmbedContainer(parent),
       d(new Private(this))
@@ -199,62 +321,36 @@ void X11EmbedContainer::paintEvent(QPaintEvent *event)
     p.eraseRect(0, 0, x() + width(), y() + height());
     p.translate(x(), y());
 
-    // Taking a detour via a QPixmap is unfortunately the only way we can get
-    // the window contents into Qt's backing store.
-    QPixmap pixmap(size());
-    if (pixmap.paintEngine()->type() != QPaintEngine::X11) {
-        // If we're using the raster or OpenGL graphics systems, a QPixmap isn't an X pixmap,
-        // so we have to get the window contents into a QImage and then draw that.
-        Display *dpy = x11Info().display();
-
-        // XXX We really should keep a cached copy of the image client side, and only
-        //     update it in response to a damage event.
-        Pixmap pixmap = XCompositeNameWindowPixmap(dpy, clientWinId());
-
-        // Extract XImage from pixmap, trying to cope with different behaviors.
-        // There are two possible sizes: 
-        // #1: width() x height(), which is 24 x 24 in our situation
-        // #2: d->attr.width x d->attr.height
-        //
-        // - Mumble 1.2.3 returns a correct image when asked for an image of
-        // size #1 , but returns a 22 x 22 cropped icon when asked for an image
-        // of size #2.
-        //
-        // - Pidgin 2.7.9 returns a NULL image when asked for an image of size
-        // #1 but returns a correct 16 x 16 image when asked for an image of
-        // size #2.
-        XImage *ximage = XGetImage(dpy, pixmap, 0, 0, width(), height(), AllPlanes, ZPixmap);
-        if (!ximage) {
-            // Make sure the attr are updated, Pidgin changes its widthxheight late in the game
-            if (!XGetWindowAttributes(QX11Info::display(), clientWinId(), &d->attr)) {
-                error(QX11EmbedContainer::Unknown);
-                return;
-            }
-
-            int ximageWidth = qMin(d->attr.width, width());
-            int ximageHeight = qMin(d->attr.height, height());
-            ximage = XGetImage(dpy, pixmap, 0, 0, ximageWidth, ximageHeight, AllPlanes, ZPixmap);
-        }
-        XFreePixmap(dpy, pixmap);
-        if (!ximage) {
-            UQ_WARNING << "Failed to get an XImage from X11 window with XID=" << clientWinId();
-            return;
+    // Taking a detour via a QPixmap or a QImage is unfortunately the only way
+    // we can get the window contents into Qt's backing store. Both are kept
+    // between paints and only the parts reported as damaged are updated.
+    if (pixmapsAreX11()) {
+        d->updatePixmapCache();
+        p.drawPixmap(0, 0, d->pixmap);
+    } else {
+        d->updateImageCache();
+        if (!d->image.isNull()) {
+            p.drawImage((width() - d->image.width()) / 2, (height() - d->image.height()) / 2, d->image);
         }
-        // This is safe to do since we only composite ARGB32 windows, and PictStandardARGB32
-        // matches QImage::Format_ARGB32_Premultiplied.
-        QImage image((const uchar*)ximage->data, ximage->width, ximage->height, ximage->bytes_per_line,
-                     QImage::Format_ARGB32_Premultiplied);
+    }
+}
 
-        p.drawImage((width() - image.width()) / 2, (height() - image.height()) / 2, image);
+void X11EmbedContainer::resizeEvent(QResizeEvent *event)
+{
+    QX11EmbedContainer::resizeEvent(event);
+    d->cacheValid = false;
+}
 
-        XDestroyImage(ximage);
+void X11EmbedContainer::addDamage(const QRegion &region)
+{
+    d->damage += region;
+    if (!d->cacheValid) {
+        update();
+    } else if (pixmapsAreX11()) {
+        update(region);
     } else {
-        pixmap.fill(Qt::transparent);
-
-        XRenderComposite(x11Info().display(), PictOpSrc, d->picture, None, pixmap.x11PictureHandle(),
-                         0, 0, 0, 0, 0, 0, width(), height());
-
-        p.drawPixmap(0, 0, pixmap);
+        // The image is centered in the container
+        update(region.translated((width() - d->image.width()) / 2, (height() - d->image.height()) / 2));
     }
 }
 
@@ -40,8 +40,15 @@ public:
     void setUpdatesEnabled(bool enabled);
     void setBackgroundPixmap(const QPixmap& background);
 
+    /**
+     * Called by FdoSelectionManager when the composited client reported
+     * damage. @p region is in client coordinates.
+     */
+    void addDamage(const QRegion &region);
+
 protected:
     void paintEvent(QPaintEvent *event);
+    void resizeEvent(QResizeEvent *event);
 
 private Q_SLOTS:
     void ensureValidSize();
@@ -124,6 +124,12 @@ Item {
 
         Behavior on x { NumberAnimation { id: launcherLoaderXAnimation; duration: 125 } }
 
+        /* Nothing of the launcher is on screen, its animations are paused */
+        property bool suspended: !visibilityController.shown && !launcherLoaderXAnimation.running
+                                 && !gestureHandler.isDragging
+        onSuspendedChanged: shellManager.suspensionManager.setSuspended(launcherLoader, suspended)
+        Component.onCompleted: shellManager.suspensionManager.setSuspended(launcherLoader, suspended)
+
         SpreadMonitor {
             id: spread
             onShownChanged: if (shown) {
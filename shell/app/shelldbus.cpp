@@ -25,6 +25,10 @@
 #include "dashdbus.h"
 #include "huddbus.h"
 
+// libunity-2d
+#include <frameprofilerdbus.h>
+#include <metricsdbus.h>
+
 // Qt
 #include <QtDBus/QDBusConnection>
 
@@ -57,5 +61,11 @@ ShellDBus::connectToBus()
     HUDDBus *hudDBus = new HUDDBus(m_manager, this);
     QDBusConnection::sessionBus().registerObject(HUD_DBUS_OBJECT_PATH, hudDBus);
 
+    MetricsDBus *metricsDBus = new MetricsDBus(this);
+    metricsDBus->connectToBus();
+
+    FrameProfilerDBus *frameProfilerDBus = new FrameProfilerDBus(this);
+    frameProfilerDBus->connectToBus();
+
     return true;
 }
@@ -42,6 +42,7 @@
 // X11
 #include <X11/Xlib.h>
 #include <X11/Xatom.h>
+#include <x11properties.h>
 
 ShellDeclarativeView::ShellDeclarativeView(ShellManager *manager, const QUrl &sourceFileUrl, int screen)
     : Unity2DDeclarativeView()
@@ -143,14 +144,15 @@ void
 ShellDeclarativeView::setWMFlags()
 {
     Display *display = QX11Info::display();
-    Atom stateAtom = XInternAtom(display, "_NET_WM_STATE", False);
+    X11Properties* properties = X11Properties::instance();
+    Atom stateAtom = properties->atom("_NET_WM_STATE");
     Atom propAtom;
 
-    propAtom = XInternAtom(display, "_NET_WM_STATE_SKIP_TASKBAR", False);
+    propAtom = properties->atom("_NET_WM_STATE_SKIP_TASKBAR");
     XChangeProperty(display, effectiveWinId(), stateAtom,
                     XA_ATOM, 32, PropModeAppend, (unsigned char *) &propAtom, 1);
 
-    propAtom = XInternAtom(display, "_NET_WM_STATE_SKIP_PAGER", False);
+    propAtom = properties->atom("_NET_WM_STATE_SKIP_PAGER");
     XChangeProperty(display, effectiveWinId(), stateAtom,
                     XA_ATOM, 32, PropModeAppend, (unsigned char *) &propAtom, 1);
 }
@@ -23,10 +23,13 @@
 #include <QDebug>
 #include <QtDeclarative>
 #include <QDesktopWidget>
+#include <QElapsedTimer>
+#include <QTimer>
 #include <QX11Info>
 
 // libunity-2d-private
 #include <applicationslistmanager.h>
+#include <declarativecomponentcache.h>
 #include <debug_p.h>
 #include <gkeysequenceparser.h>
 #include <hotmodifier.h>
@@ -34,9 +37,11 @@
 #include <hotkey.h>
 #include <keymonitor.h>
 #include <screeninfo.h>
+#include <unity2dtrace.h>
 
 // Local
 #include "shelldeclarativeview.h"
+#include "suspensionmanager.h"
 #include "config.h"
 
 // unity-2d
@@ -60,6 +65,24 @@ static const char* COMMANDS_LENS_ID = "commands.lens";
 static const int DASH_MIN_SCREEN_WIDTH = 1280;
 static const int DASH_MIN_SCREEN_HEIGHT = 1084;
 static const char* HUD_SHORTCUT_KEY = "/apps/compiz-1/plugins/unityshell/screen0/options/show_hud";
+/* Give the shell of the first screen time to get painted before creating the
+   ones of the other screens in lazy mode */
+static const int LAZY_SHELL_DELAY = 500;
+
+/* Components loaded on demand, e.g. when opening a lens for the first time,
+   which are compiled ahead of time when idle. Relative to the shell directory. */
+static const char* PRELOADED_COMPONENTS[] = {
+    "launcher/LauncherItem.qml",
+    "dash/RendererGrid.qml",
+    "dash/TileVertical.qml",
+    "dash/TileHorizontal.qml",
+    "dash/FilterCheckoption.qml",
+    "dash/FilterCheckoptionCompact.qml",
+    "dash/FilterMultirange.qml",
+    "dash/FilterRadiooption.qml",
+    "dash/FilterRatings.qml",
+    NULL
+};
 
 GOBJECT_CALLBACK1(activeWorkspaceChangedCB, "onActiveWorkspaceChanged");
 GOBJECT_CALLBACK0(iconThemeChangedCB, "onIconThemeChanged");
@@ -76,6 +99,9 @@ struct ShellManagerPrivate
         , m_dashMode(ShellManager::DesktopMode)
         , m_superHotModifier(NULL)
         , m_last_focused_window(None)
+        , m_screenCount(0)
+        , m_lazyScreens(false)
+        , m_suspensionManager(NULL)
     {}
 
     enum ActiveShellUsage {
@@ -84,8 +110,9 @@ struct ShellManagerPrivate
     };
 
     ShellDeclarativeView* initShell(int screen);
+    void initShells(int count);
     void updateScreenCount(int newCount);
-    ShellDeclarativeView* activeShell(ActiveShellUsage usage) const;
+    ShellDeclarativeView* activeShell(ActiveShellUsage usage);
     void moveDashToShell(ShellDeclarativeView* newShell);
     void moveHudToShell(ShellDeclarativeView* newShell);
     void saveActiveWindow();
@@ -110,12 +137,24 @@ struct ShellManagerPrivate
     WId m_last_focused_window;
 
     GConfItemQmlWrapper *m_gconfItem;
+
+    /* In lazy mode m_viewList only holds the shells of the first screens,
+       the others are created by m_lazyShellTimer or when first needed */
+    int m_screenCount;
+    bool m_lazyScreens;
+    QTimer m_lazyShellTimer;
+
+    SuspensionManager* m_suspensionManager;
 };
 
 
 ShellDeclarativeView *
 ShellManagerPrivate::initShell(int screen)
 {
+    UQ_TRACE_SCOPE("ShellManagerPrivate::initShell");
+    QElapsedTimer timer;
+    timer.start();
+
     const QStringList arguments = qApp->arguments();
     ShellDeclarativeView * view = new ShellDeclarativeView(q, m_sourceFileUrl, screen);
     if (arguments.contains("-opengl")) {
@@ -129,14 +168,19 @@ ShellManagerPrivate::initShell(int screen)
 
     view->rootContext()->setContextProperty("shellManager", q);
     view->rootContext()->setContextProperty("applicationsManager", ApplicationsListManager::instance());
+    const qint64 createTime = timer.restart();
 
+    /* Showing the view loads the QML */
     view->show();
+    const qint64 showTime = timer.elapsed();
+
+    UQ_DEBUG << "Shell of screen" << screen << "created in" << createTime << "ms, QML loaded in" << showTime << "ms";
 
     return view;
 }
 
 ShellDeclarativeView *
-ShellManagerPrivate::activeShell(ActiveShellUsage usage) const
+ShellManagerPrivate::activeShell(ActiveShellUsage usage)
 {
     bool launcherOnlyInOneScreen = launcher2dConfiguration().property("onlyOneLauncher").toBool();
     if (usage == ActiveShellLauncherRelatedUse && launcherOnlyInOneScreen) {
@@ -144,6 +188,10 @@ ShellManagerPrivate::activeShell(ActiveShellUsage usage) const
     }
 
     int cursorScreen = QApplication::desktop()->screenNumber(QCursor::pos());
+    if (cursorScreen >= m_viewList.size() && cursorScreen < m_screenCount) {
+        /* The shell of that screen is needed right now */
+        initShells(cursorScreen + 1);
+    }
     Q_FOREACH(ShellDeclarativeView * shell, m_viewList) {
         if (shell->screen()->screen() == cursorScreen) {
             return shell;
@@ -153,12 +201,11 @@ ShellManagerPrivate::activeShell(ActiveShellUsage usage) const
 }
 
 void
-ShellManagerPrivate::updateScreenCount(int newCount)
+ShellManagerPrivate::initShells(int count)
 {
-    const int previousCount = m_viewList.size();
-
-    /* Instantiate new Shells as needed. */
-    for (int screen = previousCount; screen < newCount; ++screen) {
+    /* Shells are always created in screen order, so that m_viewList[i] is the
+       shell of screen i */
+    for (int screen = m_viewList.size(); screen < count; ++screen) {
         ShellDeclarativeView *shell = initShell(screen);
         m_viewList.append(shell);
 
@@ -174,11 +221,29 @@ ShellManagerPrivate::updateScreenCount(int newCount)
             m_hudLoader = qobject_cast<QDeclarativeItem*>(m_shellWithHud->rootObject()->property("hudLoader").value<QObject *>());
             if (m_hudLoader != NULL) {
                 QObject::connect(m_hudLoader, SIGNAL(activeChanged()), q, SIGNAL(hudActiveChanged()));
+                QObject::connect(m_hudLoader, SIGNAL(animatingChanged()), q, SLOT(updateSuspension()));
             } else {
                 qWarning() << "Could not find the hudLoader";
             }
+            q->updateSuspension();
         }
     }
+}
+
+void
+ShellManagerPrivate::updateScreenCount(int newCount)
+{
+    m_screenCount = newCount;
+
+    /* Instantiate new Shells as needed. In lazy mode only the first screen
+       gets its shell right away. */
+    initShells(m_lazyScreens ? qMin(newCount, 1) : newCount);
+    if (m_viewList.size() < newCount) {
+        m_lazyShellTimer.start();
+    } else {
+        /* The screens still waiting for their shell may be gone */
+        m_lazyShellTimer.stop();
+    }
 
     /* Remove extra Shells if any. */
     while (m_viewList.size() > newCount) {
@@ -279,10 +344,18 @@ ShellManager::ShellManager(const QUrl &sourceFileUrl, QObject* parent) :
     QObject(parent)
     ,d(new ShellManagerPrivate)
 {
+    UQ_TRACE_SCOPE("ShellManager");
     d->q = this;
     d->m_sourceFileUrl = sourceFileUrl;
     d->m_hudHotModifier = NULL;
     d->m_hudHotKey = NULL;
+    d->m_lazyScreens = unity2dConfiguration().property("lazyScreens").toBool();
+    d->m_lazyShellTimer.setSingleShot(true);
+    d->m_lazyShellTimer.setInterval(LAZY_SHELL_DELAY);
+    connect(&d->m_lazyShellTimer, SIGNAL(timeout()), SLOT(initNextLazyShell()));
+    d->m_suspensionManager = new SuspensionManager(this);
+    connect(this, SIGNAL(dashActiveChanged(bool)), SLOT(updateSuspension()));
+    connect(this, SIGNAL(hudActiveChanged()), SLOT(updateSuspension()));
 
     d->m_gconfItem = new GConfItemQmlWrapper(this);
     connect(d->m_gconfItem, SIGNAL(valueChanged()), this, SLOT(onHudActivationShortcutChanged()));
@@ -296,6 +369,12 @@ ShellManager::ShellManager(const QUrl &sourceFileUrl, QObject* parent) :
 
     d->updateScreenCount(desktop->screenCount());
 
+    QList<QUrl> preloadedComponents;
+    for (int i = 0; PRELOADED_COMPONENTS[i] != NULL; ++i) {
+        preloadedComponents << QUrl::fromLocalFile(unity2dDirectory() + "/shell/" + PRELOADED_COMPONENTS[i]);
+    }
+    DeclarativeComponentCache::instance()->preload(preloadedComponents);
+
     connect(desktop, SIGNAL(screenCountChanged(int)), SLOT(onScreenCountChanged(int)));
 
     connect(&launcher2dConfiguration(), SIGNAL(superKeyEnableChanged(bool)), SLOT(updateSuperKeyMonitoring()));
@@ -428,6 +507,19 @@ ShellManager::onScreenCountChanged(int newCount)
     d->updateScreenCount(newCount);
 }
 
+void
+ShellManager::initNextLazyShell()
+{
+    if (d->m_viewList.size() >= d->m_screenCount) {
+        return;
+    }
+    /* One shell at a time, so that the event loop keeps running in between */
+    d->initShells(d->m_viewList.size() + 1);
+    if (d->m_viewList.size() < d->m_screenCount) {
+        d->m_lazyShellTimer.start();
+    }
+}
+
 void
 ShellManager::toggleDashRequested()
 {
@@ -500,6 +592,26 @@ void ShellManager::onIconThemeChanged()
     Q_EMIT iconThemeChanged();
 }
 
+QObject *
+ShellManager::suspensionManager() const
+{
+    return d->m_suspensionManager;
+}
+
+void ShellManager::updateSuspension()
+{
+    /* The dash disappears as soon as it is deactivated, the HUD once it has
+       been animated away */
+    QObject* dashLoader = NULL;
+    if (d->m_shellWithDash != NULL && d->m_shellWithDash->rootObject() != NULL) {
+        dashLoader = d->m_shellWithDash->rootObject()->property("dashLoader").value<QObject *>();
+    }
+    d->m_suspensionManager->setDashSuspended(dashLoader, !dashActive());
+
+    const bool hudAnimating = d->m_hudLoader != NULL && d->m_hudLoader->property("animating").toBool();
+    d->m_suspensionManager->setHudSuspended(d->m_hudLoader, !hudActive() && !hudAnimating);
+}
+
 void ShellManager::onHudActivationShortcutChanged()
 {
     // TODO It might make sense to abstract this logic
@@ -43,6 +43,7 @@ class ShellManager : public QObject
     Q_PROPERTY(QObject *hudShell READ hudShell NOTIFY hudShellChanged)
     Q_PROPERTY(int hudScreen READ hudScreen NOTIFY hudScreenChanged)
     Q_PROPERTY(unsigned int lastFocusedWindow READ lastFocusedWindow NOTIFY lastFocusedWindowChanged)
+    Q_PROPERTY(QObject *suspensionManager READ suspensionManager CONSTANT)
 
 public:
     enum DashMode {
@@ -81,6 +82,8 @@ public:
 
     unsigned int lastFocusedWindow() const;
 
+    QObject *suspensionManager() const;
+
     void forceActivateShell(ShellDeclarativeView *shell);
     void forceDeactivateShell(ShellDeclarativeView *shell);
 
@@ -105,6 +108,7 @@ Q_SIGNALS:
 
 private Q_SLOTS:
     void onScreenCountChanged(int);
+    void initNextLazyShell();
 
     void updateSuperKeyMonitoring();
 
@@ -122,6 +126,8 @@ private Q_SLOTS:
 
     void onIconThemeChanged();
 
+    void updateSuspension();
+
 private:
     Q_DISABLE_COPY(ShellManager)
     ShellManagerPrivate * const d;
@@ -0,0 +1,184 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+
+#include "suspensionmanager.h"
+
+// Qt
+#include <QGraphicsObject>
+#include <QSet>
+
+// libunity-2d-private
+#include <debug_p.h>
+#include <unity2dmetrics.h>
+
+/* Delegates of views are graphics children of their view, not QObject
+   children, so both trees are walked */
+static void findAnimations(QObject* object, QSet<QObject*>* visited, QList<QPointer<QObject> >* animations)
+{
+    if (visited->contains(object)) {
+        return;
+    }
+    visited->insert(object);
+
+    if (object->inherits("QDeclarativeAbstractAnimation")) {
+        animations->append(object);
+        /* Child animations are driven by their group */
+        return;
+    }
+
+    Q_FOREACH(QObject* child, object->children()) {
+        findAnimations(child, visited, animations);
+    }
+    QGraphicsObject* graphicsObject = qobject_cast<QGraphicsObject*>(object);
+    if (graphicsObject != NULL) {
+        Q_FOREACH(QGraphicsItem* childItem, graphicsObject->childItems()) {
+            QGraphicsObject* child = childItem->toGraphicsObject();
+            if (child != NULL) {
+                findAnimations(child, visited, animations);
+            }
+        }
+    }
+}
+
+SuspensionManager::SuspensionManager(QObject* parent)
+: QObject(parent)
+, m_dashSuspended(false)
+, m_hudSuspended(false)
+{
+}
+
+bool SuspensionManager::dashSuspended() const
+{
+    return m_dashSuspended;
+}
+
+void SuspensionManager::setDashSuspended(QObject* dash, bool suspended)
+{
+    if (dash != NULL) {
+        setSuspended(dash, suspended);
+    }
+    if (m_dashSuspended != suspended) {
+        m_dashSuspended = suspended;
+        Q_EMIT dashSuspendedChanged(suspended);
+    }
+}
+
+bool SuspensionManager::hudSuspended() const
+{
+    return m_hudSuspended;
+}
+
+void SuspensionManager::setHudSuspended(QObject* hud, bool suspended)
+{
+    if (hud != NULL) {
+        setSuspended(hud, suspended);
+    }
+    if (m_hudSuspended != suspended) {
+        m_hudSuspended = suspended;
+        Q_EMIT hudSuspendedChanged(suspended);
+    }
+}
+
+bool SuspensionManager::isSuspended(QObject* component) const
+{
+    return m_suspendedComponents.contains(component);
+}
+
+void SuspensionManager::setSuspended(QObject* component, bool suspended)
+{
+    if (component == NULL || suspended == isSuspended(component)) {
+        return;
+    }
+
+    if (suspended) {
+        SuspendedComponent& suspendedComponent = m_suspendedComponents[component];
+        QSet<QObject*> visited;
+        findAnimations(component, &visited, &suspendedComponent.animations);
+        Q_FOREACH(const QPointer<QObject>& animation, suspendedComponent.animations) {
+            m_componentForAnimation.insert(animation, component);
+            connect(animation, SIGNAL(runningChanged(bool)), SLOT(onAnimationRunningChanged(bool)));
+            pauseAnimation(animation, &suspendedComponent);
+        }
+        connect(component, SIGNAL(destroyed(QObject*)), SLOT(onComponentDestroyed(QObject*)));
+        UQ_DEBUG << "Suspended" << component << "pausing" << suspendedComponent.pausedAnimations.count()
+                 << "of its" << suspendedComponent.animations.count() << "animations";
+    } else {
+        const SuspendedComponent suspendedComponent = m_suspendedComponents.take(component);
+        Q_FOREACH(const QPointer<QObject>& animation, suspendedComponent.animations) {
+            if (!animation.isNull()) {
+                m_componentForAnimation.remove(animation);
+                disconnect(animation, SIGNAL(runningChanged(bool)), this, SLOT(onAnimationRunningChanged(bool)));
+            }
+        }
+        Q_FOREACH(const QPointer<QObject>& animation, suspendedComponent.pausedAnimations) {
+            /* It may have been stopped or deleted meanwhile */
+            if (!animation.isNull() && animation->property("paused").toBool()) {
+                animation->setProperty("paused", false);
+            }
+        }
+        disconnect(component, SIGNAL(destroyed(QObject*)), this, SLOT(onComponentDestroyed(QObject*)));
+        UQ_DEBUG << "Resumed" << component;
+    }
+    updateMetrics();
+}
+
+void SuspensionManager::pauseAnimation(QObject* animation, SuspendedComponent* component)
+{
+    if (animation->property("running").toBool() && !animation->property("paused").toBool()) {
+        animation->setProperty("paused", true);
+        if (!component->pausedAnimations.contains(animation)) {
+            component->pausedAnimations.append(animation);
+        }
+    }
+}
+
+void SuspensionManager::onAnimationRunningChanged(bool running)
+{
+    QObject* component = m_componentForAnimation.value(sender());
+    if (!running || component == NULL || !m_suspendedComponents.contains(component)) {
+        return;
+    }
+    /* Started while its component is off screen */
+    pauseAnimation(sender(), &m_suspendedComponents[component]);
+    updateMetrics();
+}
+
+void SuspensionManager::onComponentDestroyed(QObject* component)
+{
+    /* Its animations are destroyed with it, some of them already are */
+    m_suspendedComponents.remove(component);
+    QHash<QObject*, QObject*>::iterator it = m_componentForAnimation.begin();
+    while (it != m_componentForAnimation.end()) {
+        if (it.value() == component) {
+            it = m_componentForAnimation.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    updateMetrics();
+}
+
+void SuspensionManager::updateMetrics()
+{
+    int pausedAnimations = 0;
+    Q_FOREACH(const SuspendedComponent& component, m_suspendedComponents) {
+        pausedAnimations += component.pausedAnimations.count();
+    }
+    UQ_METRIC_GAUGE("suspension.components", m_suspendedComponents.count());
+    UQ_METRIC_GAUGE("suspension.paused_animations", pausedAnimations);
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>
+ */
+#ifndef SUSPENSIONMANAGER_H
+#define SUSPENSIONMANAGER_H
+
+// Qt
+#include <QHash>
+#include <QList>
+#include <QObject>
+#include <QPointer>
+
+/**
+ * Stops the periodic work of the parts of the shell that are not on screen,
+ * so that an idle shell does not keep waking the CPU up.
+ *
+ * Suspending a component pauses the animations running in it, found by
+ * walking its objects and its graphics items, and the ones of them started
+ * while it is suspended, e.g. by a binding on their "running" property.
+ * Resuming it lets them go on. Animations created while the component is
+ * suspended, e.g. in the delegate of an item added meanwhile, are not seen:
+ * the QML code has to gate them, as the launcher does for the launching
+ * animation of its tiles.
+ *
+ * Timers cannot be stopped from here without fighting the bindings of their
+ * "running" property, so the QML code binds them to the dashSuspended and
+ * hudSuspended properties, or to the "suspended" property of the launcher
+ * loader, instead.
+ *
+ * The effect can be checked with WakeupsPerSecond on the /Metrics D-Bus
+ * object.
+ */
+class SuspensionManager : public QObject
+{
+    Q_OBJECT
+    Q_PROPERTY(bool dashSuspended READ dashSuspended NOTIFY dashSuspendedChanged)
+    Q_PROPERTY(bool hudSuspended READ hudSuspended NOTIFY hudSuspendedChanged)
+
+public:
+    SuspensionManager(QObject* parent = 0);
+
+    bool dashSuspended() const;
+    void setDashSuspended(QObject* dash, bool suspended);
+
+    bool hudSuspended() const;
+    void setHudSuspended(QObject* hud, bool suspended);
+
+    /**
+     * Suspends or resumes @p component, e.g. the launcher of a shell.
+     * Suspending a component twice does nothing.
+     */
+    Q_INVOKABLE void setSuspended(QObject* component, bool suspended);
+    bool isSuspended(QObject* component) const;
+
+Q_SIGNALS:
+    void dashSuspendedChanged(bool suspended);
+    void hudSuspendedChanged(bool suspended);
+
+private Q_SLOTS:
+    void onComponentDestroyed(QObject* component);
+    void onAnimationRunningChanged(bool running);
+
+private:
+    struct SuspendedComponent
+    {
+        // Top level animations of the component
+        QList<QPointer<QObject> > animations;
+        // The ones that were paused by us
+        QList<QPointer<QObject> > pausedAnimations;
+    };
+
+    void pauseAnimation(QObject* animation, SuspendedComponent* component);
+    void updateMetrics();
+
+    bool m_dashSuspended;
+    bool m_hudSuspended;
+    QHash<QObject*, SuspendedComponent> m_suspendedComponents;
+    QHash<QObject*, QObject*> m_componentForAnimation;
+};
+
+#endif // SUSPENSIONMANAGER_H
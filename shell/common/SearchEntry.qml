@@ -28,6 +28,8 @@ AbstractButton {
     property bool active: false
     property alias forceCursorVisible: searchInput.forceCursorVisible
     property alias anyKeypressGivesFocus: searchInput.anyKeypressGivesFocus
+    /* Set while the entry is off screen, the cursor stops blinking */
+    property bool suspended: false
 
     signal returnPressed
 
@@ -144,7 +146,7 @@ AbstractButton {
                     width: 1
                     visible: (customCursor.parent.forceCursorVisible || parent.activeFocus) && timerShowCursor
                     Timer {
-                        interval: 800; running: (customCursor.parent.forceCursorVisible || customCursor.parent.activeFocus); repeat: true
+                        interval: 800; running: !suspended && (customCursor.parent.forceCursorVisible || customCursor.parent.activeFocus); repeat: true
                         onTriggered: {
                             interval = interval == 800 ? 400 : 800
                             customCursor.timerShowCursor = !customCursor.timerShowCursor
@@ -347,6 +347,7 @@ FocusScope {
             id: search_entry
 
             focus: true
+            suspended: shellManager.suspensionManager.dashSuspended
             /* FIXME: check on visible necessary; fixed in Qt Quick 1.1
                       ref: http://bugreports.qt.nokia.com/browse/QTBUG-15862
             */
@@ -201,6 +201,7 @@ FocusScope {
                 focus: true
                 forceCursorVisible: true
                 anyKeypressGivesFocus: true
+                suspended: shellManager.suspensionManager.hudSuspended
 
                 anchors.top: parent.top
                 anchors.left: parent.left
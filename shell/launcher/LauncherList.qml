@@ -121,7 +121,8 @@ AutoScrollingListView {
         active: item.active
         activeOnThisScreen: item.activeScreen == declarativeView.screen.screen
         urgent: item.urgent
-        launching: item.launching
+        /* Do not start pulsing while the launcher is hidden */
+        launching: item.launching && !launcherLoader.suspended
 
         counter: item.counter
         counterVisible: item.counterVisible
@@ -23,6 +23,9 @@
 #include "spreadcontrol.h"
 #include "spreadadaptor.h"
 
+#include <frameprofilerdbus.h>
+#include <metricsdbus.h>
+
 static const char* DBUS_SERVICE = "com.canonical.Unity2d.Spread";
 static const char* DBUS_OBJECT_PATH = "/Spread";
 
@@ -54,6 +57,12 @@ bool SpreadControl::connectToBus()
     new SpreadAdaptor(this);
     QDBusConnection::sessionBus().registerObject(DBUS_OBJECT_PATH, this);
 
+    MetricsDBus *metricsDBus = new MetricsDBus(this);
+    metricsDBus->connectToBus();
+
+    FrameProfilerDBus *frameProfilerDBus = new FrameProfilerDBus(this);
+    frameProfilerDBus->connectToBus();
+
     return true;
 }
 
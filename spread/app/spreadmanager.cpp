@@ -20,6 +20,7 @@
 
 #include <config.h>
 #include <screeninfo.h>
+#include <unity2dtrace.h>
 
 #include <QApplication>
 #include <QDebug>
@@ -33,6 +34,7 @@ SpreadManager::SpreadManager(QObject* parent)
  , m_eventGrabbingView(NULL)
  , m_focusedView(NULL)
 {
+    UQ_TRACE_SCOPE("SpreadManager");
     qmlRegisterUncreatableType<SpreadView>("Unity2d", 1, 0, "SpreadView", "This can only be created from C++");
 
     QDesktopWidget* desktop = QApplication::desktop();
@@ -0,0 +1,64 @@
+#!/usr/bin/python
+
+#
+# Stress test for the legacy tray: shows animated system tray icons, each of
+# them sending damage to the panel at the given rate.
+# Run without arguments for usage.
+#
+
+from gi.repository import Gtk, GdkPixbuf, GLib
+import sys
+
+usage = """Usage:
+fake_tray_icons.py <count> [fps]
+
+  count Number of tray icons to show (e.g. 30)
+  fps   Animation rate of each icon, defaults to 60
+
+Add 'fake-tray-icons' to /desktop/unity/panel/systray-whitelist in dconf-editor
+for the icons to be accepted by the panel.
+"""
+
+ICON_SIZE = 22
+FRAME_COUNT = 16
+
+if len(sys.argv) < 2:
+    sys.exit(usage)
+
+count = int(sys.argv[1])
+fps = int(sys.argv[2]) if len(sys.argv) > 2 else 60
+
+GLib.set_prgname('fake-tray-icons')
+
+# Pre-render the frames so that the client does not waste CPU time in the
+# measurements: each frame is a bar at a different height
+frames = []
+for frame in range(FRAME_COUNT):
+    pixbuf = GdkPixbuf.Pixbuf.new(GdkPixbuf.Colorspace.RGB, True, 8, ICON_SIZE, ICON_SIZE)
+    pixbuf.fill(0x00000000)
+    y = frame * (ICON_SIZE - 4) / FRAME_COUNT
+    bar = pixbuf.new_subpixbuf(0, y, ICON_SIZE, 4)
+    bar.fill(0xdd4814ff)
+    frames.append(pixbuf)
+
+icons = []
+for i in range(count):
+    icon = Gtk.StatusIcon.new_from_pixbuf(frames[0])
+    icon.set_tooltip_text('Fake tray icon %d' % i)
+    icons.append(icon)
+
+state = {'frame': 0}
+
+def animate():
+    state['frame'] = (state['frame'] + 1) % FRAME_COUNT
+    for i, icon in enumerate(icons):
+        # Shift each icon so that they do not all damage the same area
+        icon.set_from_pixbuf(frames[(state['frame'] + i) % FRAME_COUNT])
+    return True
+
+GLib.timeout_add(1000 / fps, animate)
+print 'Animating %d tray icons at %d fps, hit Ctrl+C to stop' % (count, fps)
+try:
+    Gtk.main()
+except KeyboardInterrupt:
+    pass
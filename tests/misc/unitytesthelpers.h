@@ -0,0 +1,76 @@
+/*
+ * This file is part of unity-2d
+ *
+ * Copyright 2012 Canonical Ltd.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; version 3.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef UNITYTESTHELPERS_H
+#define UNITYTESTHELPERS_H
+
+#include <QDir>
+#include <QProcess>
+#include <QString>
+#include <QStringList>
+
+#include <unistd.h>
+
+/* Number of events of a recorded trace array */
+#define TRACE_LENGTH(trace) (sizeof(trace) / sizeof((trace)[0]))
+
+namespace UnityTest
+{
+
+/*
+ * Feeds @p count events of a recorded @p trace to @p replayEvent, called with
+ * each event and its index in the trace
+ */
+template <typename Event, typename Replayer>
+void replayTrace(const Event* trace, int count, Replayer replayEvent)
+{
+    for (int i = 0; i < count; ++i) {
+        replayEvent(trace[i], i);
+    }
+}
+
+/*
+ * Directory unique to the test process, removed with its content when going
+ * out of scope (QTemporaryDir only comes with Qt 5)
+ */
+class TemporaryDir
+{
+public:
+    TemporaryDir(const QString& name)
+    : m_path(QDir::tempPath() + QString("/%1-%2").arg(name).arg(getpid()))
+    {
+        QDir().mkpath(m_path);
+    }
+
+    ~TemporaryDir()
+    {
+        QProcess::execute("rm", QStringList() << "-rf" << m_path);
+    }
+
+    QString path() const
+    {
+        return m_path;
+    }
+
+private:
+    QString m_path;
+};
+
+} // namespace UnityTest
+
+#endif